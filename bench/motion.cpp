@@ -0,0 +1,341 @@
+#include "animator.hpp"
+#include "iksolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Round trip of the compressed motion format. A synthetic motion is compressed,
+// its keyframes are decoded again and the Animator samples it between keyframes;
+// everything is compared against a double precision reference that slerps the
+// source keyframes. Also reports the memory of both forms, the sampling time and
+// the time IK takes for a PMX sized character. 'make bench-motion' builds and runs it.
+
+namespace mth = democollection::mth;
+using democollection::Animator;
+using democollection::BoneKeyframe;
+using democollection::BoneTrack;
+using democollection::CompressedMotion;
+using democollection::IkChain;
+using democollection::IkLink;
+using democollection::IkSolver;
+using democollection::Motion;
+using democollection::Pose;
+using democollection::Skeleton;
+
+namespace
+{
+	constexpr size_t TRACK_COUNT = 50;
+	constexpr size_t KEYFRAMES_PER_TRACK = 40;
+	constexpr float TRANSLATION_RANGE = 10.0f;	// translations are in [-range, range]
+	constexpr size_t SAMPLE_COUNT = 4000;
+	constexpr int RUN_COUNT = 5;
+	constexpr size_t IK_SOLVE_COUNT = 2000;
+	constexpr double IK_BUDGET_US = 50.0;	// per character and frame
+
+	// Keyframes may be anywhere up to half a turn apart, the worst case for nlerp
+	Motion MakeMotion()
+	{
+		std::mt19937 rng(12345);
+		std::normal_distribution<float> normal;
+		std::uniform_real_distribution<float> translation(-TRANSLATION_RANGE, TRANSLATION_RANGE);
+		std::uniform_int_distribution<uint32_t> frameStep(1, 30);
+		std::uniform_int_distribution<int> curveByte(0, 127);
+
+		Motion motion;
+		motion.boneTracks.reserve(TRACK_COUNT);
+		for (size_t t = 0; t < TRACK_COUNT; ++t)
+		{
+			BoneTrack track;
+			track.boneName = "bone" + std::to_string(t);
+			track.keyframes.reserve(KEYFRAMES_PER_TRACK);
+			uint32_t frame = 0;
+			for (size_t k = 0; k < KEYFRAMES_PER_TRACK; ++k)
+			{
+				BoneKeyframe keyframe;
+				keyframe.frame = frame;
+				keyframe.translation = mth::float3(translation(rng), translation(rng), translation(rng));
+				keyframe.rotation = mth::Normalized(mth::Quaternionf(normal(rng), normal(rng), normal(rng), normal(rng)));
+				// VMD stores the control points as bytes
+				for (democollection::Bezier& curve : keyframe.curves)
+				{
+					curve.x1 = curveByte(rng) / CompressedMotion::CURVE_MAX;
+					curve.y1 = curveByte(rng) / CompressedMotion::CURVE_MAX;
+					curve.x2 = curveByte(rng) / CompressedMotion::CURVE_MAX;
+					curve.y2 = curveByte(rng) / CompressedMotion::CURVE_MAX;
+				}
+				track.keyframes.push_back(keyframe);
+				frame += frameStep(rng);
+			}
+			motion.lastFrame = std::max(motion.lastFrame, track.keyframes.back().frame);
+			motion.boneTracks.push_back(std::move(track));
+		}
+		return motion;
+	}
+
+	// Bones of a typical MMD model in PMX order: body and arms with fingers, then the
+	// legs and their IK bones. The chains use the loop counts and limits PMX models ship
+	// with, 40 iterations for the legs with a limited knee and 3 for the toes.
+	democollection::Skeleton MakePmxSkeleton(std::vector<IkChain>& chains)
+	{
+		democollection::Skeleton skeleton;
+		const int root = skeleton.AddBone("root", -1, mth::float3(0.0f));
+		const int center = skeleton.AddBone("center", root, mth::float3(0.0f, 8.0f, 0.0f));
+		const int groove = skeleton.AddBone("groove", center, mth::float3(0.0f, 8.0f, 0.0f));
+		const int waist = skeleton.AddBone("waist", groove, mth::float3(0.0f, 12.0f, 0.0f));
+		const int upperBody = skeleton.AddBone("upper body", waist, mth::float3(0.0f, 12.5f, 0.0f));
+		const int upperBody2 = skeleton.AddBone("upper body 2", upperBody, mth::float3(0.0f, 14.0f, 0.0f));
+		const int neck = skeleton.AddBone("neck", upperBody2, mth::float3(0.0f, 17.0f, 0.0f));
+		const int head = skeleton.AddBone("head", neck, mth::float3(0.0f, 18.5f, 0.0f));
+		for (float side : {1.0f, -1.0f})
+		{
+			skeleton.AddBone("eye", head, mth::float3(side * 0.3f, 20.5f, -0.8f));
+			int bone = skeleton.AddBone("shoulder", upperBody2, mth::float3(side * 0.5f, 16.5f, 0.0f));
+			bone = skeleton.AddBone("arm", bone, mth::float3(side * 2.0f, 16.0f, 0.0f));
+			bone = skeleton.AddBone("elbow", bone, mth::float3(side * 4.5f, 16.0f, 0.0f));
+			bone = skeleton.AddBone("wrist", bone, mth::float3(side * 7.0f, 16.0f, 0.0f));
+			for (int finger = 0; finger < 5; ++finger)
+			{
+				int joint = bone;
+				for (int i = 0; i < 3; ++i)
+					joint = skeleton.AddBone("finger", joint, mth::float3(side * (9.0f + 0.5f * i), 16.0f, 0.3f * finger));
+			}
+		}
+		// hair and skirt bones, IK moves the legs before them in the order
+		for (int strand = 0; strand < 8; ++strand)
+		{
+			int bone = skeleton.AddBone("hair", head, mth::float3(0.5f * strand - 2.0f, 20.0f, 1.0f));
+			for (int i = 0; i < 4; ++i)
+				bone = skeleton.AddBone("hair", bone, mth::float3(0.5f * strand - 2.0f, 19.0f - 2.0f * i, 1.5f));
+		}
+		const int lowerBody = skeleton.AddBone("lower body", waist, mth::float3(0.0f, 12.0f, 0.0f));
+		for (float side : {1.0f, -1.0f})
+		{
+			const int leg = skeleton.AddBone("leg", lowerBody, mth::float3(side, 11.0f, 0.0f));
+			const int knee = skeleton.AddBone("knee", leg, mth::float3(side, 6.0f, -0.2f));
+			const int ankle = skeleton.AddBone("ankle", knee, mth::float3(side, 1.2f, 0.3f));
+			const int toe = skeleton.AddBone("toe", ankle, mth::float3(side, 0.0f, -1.3f));
+			const int legIk = skeleton.AddBone("leg IK", root, mth::float3(side, 1.2f, 0.3f));
+			const int toeIk = skeleton.AddBone("toe IK", legIk, mth::float3(side, 0.0f, -1.3f));
+
+			IkLink kneeLink{static_cast<uint32_t>(knee), true, mth::float3(-3.14159265f, 0.0f, 0.0f), mth::float3(-0.00872665f, 0.0f, 0.0f)};
+			IkLink legLink{static_cast<uint32_t>(leg), false, mth::float3(0.0f), mth::float3(0.0f)};
+			chains.push_back(IkChain{static_cast<uint32_t>(legIk), static_cast<uint32_t>(ankle), 40, 2.0f, {kneeLink, legLink}});
+			IkLink ankleLink{static_cast<uint32_t>(ankle), false, mth::float3(0.0f), mth::float3(0.0f)};
+			chains.push_back(IkChain{static_cast<uint32_t>(toeIk), static_cast<uint32_t>(toe), 3, 4.0f, {ankleLink}});
+		}
+		return skeleton;
+	}
+
+	size_t MemorySize(const Motion& motion)
+	{
+		size_t size = sizeof(motion) + motion.boneTracks.capacity() * sizeof(BoneTrack);
+		for (const BoneTrack& track : motion.boneTracks)
+			size += track.boneName.capacity() + track.keyframes.capacity() * sizeof(BoneKeyframe);
+		return size;
+	}
+
+	// Double precision reference, deliberately written without mth
+	struct RefQuaternion
+	{
+		double x, y, z, w;
+	};
+
+	RefQuaternion ToRef(const mth::Quaternionf& q)
+	{
+		return RefQuaternion{q.x, q.y, q.z, q.w};
+	}
+
+	RefQuaternion RefSlerp(const RefQuaternion& a, RefQuaternion b, double t)
+	{
+		double cosa = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+		if (cosa < 0.0)
+		{
+			b = RefQuaternion{-b.x, -b.y, -b.z, -b.w};
+			cosa = -cosa;
+		}
+		double ka = 1.0 - t, kb = t;
+		if (cosa < 1.0 - 1e-12)
+		{
+			const double angle = std::acos(cosa);
+			ka = std::sin((1.0 - t) * angle) / std::sin(angle);
+			kb = std::sin(t * angle) / std::sin(angle);
+		}
+		const RefQuaternion r{a.x * ka + b.x * kb, a.y * ka + b.y * kb, a.z * ka + b.z * kb, a.w * ka + b.w * kb};
+		const double length = std::sqrt(r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w);
+		return RefQuaternion{r.x / length, r.y / length, r.z / length, r.w / length};
+	}
+
+	// Angle of the rotation between two unit quaternions. acos of their dot product
+	// drowns small angles in float rounding, |a - b| = 2 sin(angle / 4) does not.
+	double Angle(const RefQuaternion& a, const RefQuaternion& b)
+	{
+		auto distance = [&](double sign) {
+			const double x = a.x - sign * b.x, y = a.y - sign * b.y, z = a.z - sign * b.z, w = a.w - sign * b.w;
+			return std::sqrt(x * x + y * y + z * z + w * w);
+		};
+		return 4.0 * std::asin(std::min(std::min(distance(1.0), distance(-1.0)) * 0.5, 1.0));
+	}
+
+	// Pose of one track at 'frame' from the source keyframes
+	void RefSample(const BoneTrack& track, double frame, RefQuaternion& rotation, double translation[3])
+	{
+		const std::vector<BoneKeyframe>& keyframes = track.keyframes;
+		size_t k = 0;
+		while (k + 1 < keyframes.size() && keyframes[k + 1].frame <= frame)
+			++k;
+		const BoneKeyframe& k0 = keyframes[k];
+		if (k + 1 == keyframes.size() || frame <= k0.frame)
+		{
+			rotation = ToRef(k0.rotation);
+			for (size_t c = 0; c < 3; ++c)
+				translation[c] = k0.translation(c);
+			return;
+		}
+		const BoneKeyframe& k1 = keyframes[k + 1];
+		const float t = static_cast<float>((frame - k0.frame) / (k1.frame - k0.frame));
+		for (size_t c = 0; c < 3; ++c)
+		{
+			const double w = k1.curves[c].Evaluate(t);
+			translation[c] = k0.translation(c) + (double(k1.translation(c)) - k0.translation(c)) * w;
+		}
+		rotation = RefSlerp(ToRef(k0.rotation), ToRef(k1.rotation), k1.curves[3].Evaluate(t));
+	}
+
+	class Checker
+	{
+		bool m_passed = true;
+
+	public:
+		void Check(const char* name, double maxError, double tolerance)
+		{
+			const bool ok = maxError <= tolerance;
+			m_passed &= ok;
+			std::cout << "  " << std::left << std::setw(32) << name << std::right
+				<< " max error " << std::scientific << std::setprecision(2) << maxError
+				<< " (tolerance " << tolerance << ") " << (ok ? "ok" : "FAILED") << std::defaultfloat << '\n';
+		}
+		bool Passed() const { return m_passed; }
+	};
+}
+
+int main()
+{
+	std::cout << "motion benchmark\n";
+
+	const Motion motion = MakeMotion();
+	const std::shared_ptr<const CompressedMotion> compressed = std::make_shared<const CompressedMotion>(motion);
+
+	Skeleton skeleton;
+	for (const BoneTrack& track : motion.boneTracks)
+		skeleton.AddBone(track.boneName, -1, mth::float3(0.0f));
+	Animator animator(skeleton, compressed);
+	Pose pose(skeleton.Size());
+	pose.SetIdentity();
+
+	std::cout << "correctness:\n";
+	Checker c;
+
+	// the three stored components are off by at most half a step, the rebuilt one by up to
+	// about four times that, which bounds the angle at a little under five steps
+	const double rotationStep = 2.0 * CompressedMotion::ROTATION_RANGE / CompressedMotion::ROTATION_MAX;
+	const double translationStep = 2.0 * TRANSLATION_RANGE / CompressedMotion::TRANSLATION_MAX;
+	double keyframeRotationError = 0.0;
+	double keyframeTranslationError = 0.0;
+	for (size_t t = 0; t < TRACK_COUNT; ++t)
+	{
+		const CompressedMotion::Track& track = compressed->Tracks()[t];
+		const CompressedMotion::Keyframe* keyframes = compressed->Keyframes(track);
+		for (size_t k = 0; k < track.keyframeCount; ++k)
+		{
+			const BoneKeyframe& source = motion.boneTracks[t].keyframes[k];
+			keyframeRotationError = std::max(keyframeRotationError,
+					Angle(ToRef(source.rotation), ToRef(CompressedMotion::DecodeRotation(keyframes[k].rotation))));
+			const mth::float3 decoded = CompressedMotion::DecodeTranslation(track, keyframes[k]);
+			for (size_t i = 0; i < 3; ++i)
+				keyframeTranslationError = std::max(keyframeTranslationError, std::abs(double(decoded(i)) - source.translation(i)));
+		}
+	}
+	c.Check("keyframe rotation (rad)", keyframeRotationError, 5.0 * rotationStep);
+	// half a step of the track's range, plus float rounding
+	c.Check("keyframe translation", keyframeTranslationError, 0.5 * translationStep * 1.01);
+
+	// nlerp with the corrected parameter stays within half a degree of slerp
+	const double SAMPLE_ROTATION_TOLERANCE = 0.0087;
+	double sampleRotationError = 0.0;
+	double sampleTranslationError = 0.0;
+	for (size_t i = 0; i < SAMPLE_COUNT; ++i)
+	{
+		const float frame = static_cast<float>(motion.lastFrame) * static_cast<float>(i) / SAMPLE_COUNT;
+		animator.Sample(frame, pose);
+		for (size_t t = 0; t < TRACK_COUNT; ++t)
+		{
+			const int bone = skeleton.FindBone(motion.boneTracks[t].boneName);
+			RefQuaternion rotation;
+			double translation[3];
+			RefSample(motion.boneTracks[t], frame, rotation, translation);
+			sampleRotationError = std::max(sampleRotationError, Angle(rotation, ToRef(pose.Rotation(bone))));
+			const mth::float3 sampled = pose.Translation(bone);
+			for (size_t k = 0; k < 3; ++k)
+				sampleTranslationError = std::max(sampleTranslationError, std::abs(sampled(k) - translation[k]));
+		}
+	}
+	c.Check("sampled rotation (rad)", sampleRotationError, SAMPLE_ROTATION_TOLERANCE);
+	// the curve weights of the reference come from the same bytes, so only quantization remains
+	c.Check("sampled translation", sampleTranslationError, translationStep);
+
+	if (!c.Passed())
+	{
+		std::cerr << "motion benchmark: correctness check failed" << std::endl;
+		return 1;
+	}
+
+	std::cout << "memory:\n";
+	std::cout << "  " << TRACK_COUNT << " tracks, " << TRACK_COUNT * KEYFRAMES_PER_TRACK << " keyframes: "
+		<< MemorySize(motion) / 1024 << " KiB source, " << compressed->MemorySize() / 1024 << " KiB compressed\n";
+
+	std::cout << "performance:\n";
+	double best = 0.0;
+	for (int run = 0; run < RUN_COUNT; ++run)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < SAMPLE_COUNT; ++i)
+			animator.Sample(static_cast<float>(motion.lastFrame) * static_cast<float>(i) / SAMPLE_COUNT, pose);
+		const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / SAMPLE_COUNT;
+		best = run == 0 ? ns : std::min(best, ns);
+	}
+	std::cout << "  Animator::Sample " << TRACK_COUNT << " tracks    " << std::fixed << std::setprecision(2) << best << " ns/op\n";
+
+	// the feet walk a loop, every fourth goal is out of reach
+	std::vector<IkChain> chains;
+	Skeleton ikSkeleton = MakePmxSkeleton(chains);
+	const IkSolver solver(ikSkeleton, chains);
+	const uint32_t legIks[2] = { chains[0].ikBone, chains[2].ikBone };
+	std::vector<double> times(IK_SOLVE_COUNT);
+	for (size_t i = 0; i < IK_SOLVE_COUNT; ++i)
+	{
+		ikSkeleton.ResetPose();
+		for (size_t side = 0; side < 2; ++side)
+		{
+			const float phase = 6.2831853f * static_cast<float>(i) / 100.0f + 3.14159265f * side;
+			const float reach = i % 4 == 3 ? -4.0f : 0.0f;
+			ikSkeleton.LocalTransform(legIks[side]) = mth::Translation3x4(
+				mth::float3(0.0f, std::max(0.0f, std::sin(phase)) * 2.0f + reach, std::cos(phase) * 3.0f));
+		}
+		ikSkeleton.UpdateGlobalTransforms();
+		const auto start = std::chrono::steady_clock::now();
+		solver.Solve(ikSkeleton);
+		times[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	}
+	// the 99th percentile rather than the maximum, which is mostly the scheduler
+	const double mean = std::accumulate(times.begin(), times.end(), 0.0) / IK_SOLVE_COUNT;
+	std::nth_element(times.begin(), times.begin() + IK_SOLVE_COUNT * 99 / 100, times.end());
+	std::cout << "  IkSolver::Solve " << ikSkeleton.Size() << " bones, " << solver.ChainCount() << " chains  "
+		<< mean << " us/op mean, " << times[IK_SOLVE_COUNT * 99 / 100] << " us 99th percentile (budget " << IK_BUDGET_US << " us)\n";
+	return 0;
+}
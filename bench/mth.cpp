@@ -0,0 +1,481 @@
+#include "mth/linalg.hpp"
+#include "mth/affine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Microbenchmarks for the mth library. Every benchmark runs an operation over
+// DATA_SIZE independent inputs so the loop is throughput bound rather than
+// latency bound, and reports the best of several runs. Before timing anything
+// the float results are checked against a double precision reference that does
+// not go through mth. The Makefile builds one binary per instruction set
+// ('make bench-mth'), BENCH_ISA names the variant.
+
+#ifndef BENCH_ISA
+#define BENCH_ISA "default"
+#endif
+
+namespace mth = democollection::mth;
+
+namespace
+{
+	constexpr size_t DATA_SIZE = 1024;
+	constexpr int RUN_COUNT = 5;
+	constexpr double MIN_RUN_TIME = 0.02;
+
+	struct Data
+	{
+		std::vector<mth::float3> vec3a, vec3b;
+		std::vector<mth::float4> vec4a, vec4b, vec4c;
+		std::vector<mth::float4x4> affineA, affineB, affineC;
+		std::vector<mth::float4x4> general;
+		std::vector<mth::Affine3x4f> affine3x4A, affine3x4B, affine3x4C;
+		std::vector<float> fov;
+		std::vector<float> angles;
+		std::vector<mth::float3> rotations;
+	};
+
+	// Keeps the compiler from dropping stores the benchmark never reads back
+	template <typename T>
+	inline void Escape(T* p)
+	{
+		asm volatile("" : : "g"(p) : "memory");
+	}
+
+	bool IsaSupported()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_cpu_init();
+#ifdef __SSE4_2__
+		if (!__builtin_cpu_supports("sse4.2"))
+			return false;
+#endif
+#ifdef __AVX__
+		if (!__builtin_cpu_supports("avx"))
+			return false;
+#endif
+#ifdef __AVX2__
+		if (!__builtin_cpu_supports("avx2"))
+			return false;
+#endif
+#ifdef __FMA__
+		if (!__builtin_cpu_supports("fma"))
+			return false;
+#endif
+#ifdef __AVX512F__
+		if (!__builtin_cpu_supports("avx512f"))
+			return false;
+#endif
+#endif
+		return true;
+	}
+
+	Data MakeData()
+	{
+		std::mt19937 rng(12345);
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+		std::uniform_real_distribution<float> wideAngle(-1000.0f, 1000.0f);
+
+		auto randomVec3 = [&]() { return mth::float3(value(rng), value(rng), value(rng)); };
+		auto randomVec4 = [&]() { return mth::float4(value(rng), value(rng), value(rng), value(rng)); };
+		auto randomAffine = [&]() {
+			return mth::ScalingRotationTranslation4x4(
+				scale(rng), scale(rng), scale(rng),
+				angle(rng), angle(rng), angle(rng),
+				value(rng) * 10.0f, value(rng) * 10.0f, value(rng) * 10.0f);
+		};
+		// diagonally dominant, so it is always safely invertible
+		auto randomGeneral = [&]() {
+			mth::float4x4 m;
+			for (size_t y = 0; y < 4; ++y)
+				for (size_t x = 0; x < 4; ++x)
+					m(x, y) = value(rng) + (x == y ? 4.0f : 0.0f);
+			return m;
+		};
+
+		Data d;
+		for (size_t i = 0; i < DATA_SIZE; ++i)
+		{
+			d.vec3a.push_back(randomVec3());
+			d.vec3b.push_back(randomVec3());
+			d.vec4a.push_back(randomVec4());
+			d.vec4b.push_back(randomVec4());
+			d.vec4c.push_back(randomVec4());
+			d.affineA.push_back(randomAffine());
+			d.affineB.push_back(randomAffine());
+			d.affineC.push_back(randomAffine());
+			d.general.push_back(randomGeneral());
+			d.affine3x4A.emplace_back(d.affineA.back());
+			d.affine3x4B.emplace_back(d.affineB.back());
+			d.affine3x4C.emplace_back(d.affineC.back());
+			d.fov.push_back(0.5f + (value(rng) + 1.0f) * 0.5f);
+			d.angles.push_back(wideAngle(rng));
+			d.rotations.emplace_back(angle(rng), angle(rng), angle(rng));
+		}
+		return d;
+	}
+
+	// Double precision reference, deliberately written without mth
+	struct Ref4x4
+	{
+		double m[4][4]; // [row][column]
+	};
+
+	Ref4x4 ToRef(const mth::float4x4& a)
+	{
+		Ref4x4 r;
+		for (size_t y = 0; y < 4; ++y)
+			for (size_t x = 0; x < 4; ++x)
+				r.m[y][x] = a(x, y);
+		return r;
+	}
+	Ref4x4 ToRef(const mth::Affine3x4f& a)
+	{
+		Ref4x4 r = {};
+		for (size_t y = 0; y < 3; ++y)
+			for (size_t x = 0; x < 4; ++x)
+				r.m[y][x] = a(x, y);
+		r.m[3][3] = 1.0;
+		return r;
+	}
+	Ref4x4 RefMultiply(const Ref4x4& a, const Ref4x4& b)
+	{
+		Ref4x4 r = {};
+		for (size_t y = 0; y < 4; ++y)
+			for (size_t x = 0; x < 4; ++x)
+				for (size_t i = 0; i < 4; ++i)
+					r.m[y][x] += a.m[y][i] * b.m[i][x];
+		return r;
+	}
+	Ref4x4 RefTranspose(const Ref4x4& a)
+	{
+		Ref4x4 r;
+		for (size_t y = 0; y < 4; ++y)
+			for (size_t x = 0; x < 4; ++x)
+				r.m[y][x] = a.m[x][y];
+		return r;
+	}
+	// Gauss-Jordan elimination with partial pivoting
+	Ref4x4 RefInverse(const Ref4x4& a)
+	{
+		double w[4][8];
+		for (size_t y = 0; y < 4; ++y)
+			for (size_t x = 0; x < 4; ++x)
+			{
+				w[y][x] = a.m[y][x];
+				w[y][x + 4] = x == y ? 1.0 : 0.0;
+			}
+		for (size_t c = 0; c < 4; ++c)
+		{
+			size_t pivot = c;
+			for (size_t y = c + 1; y < 4; ++y)
+				if (std::abs(w[y][c]) > std::abs(w[pivot][c]))
+					pivot = y;
+			for (size_t x = 0; x < 8; ++x)
+				std::swap(w[c][x], w[pivot][x]);
+			const double p = w[c][c];
+			for (size_t x = 0; x < 8; ++x)
+				w[c][x] /= p;
+			for (size_t y = 0; y < 4; ++y)
+			{
+				if (y == c)
+					continue;
+				const double f = w[y][c];
+				for (size_t x = 0; x < 8; ++x)
+					w[y][x] -= f * w[c][x];
+			}
+		}
+		Ref4x4 r;
+		for (size_t y = 0; y < 4; ++y)
+			for (size_t x = 0; x < 4; ++x)
+				r.m[y][x] = w[y][x + 4];
+		return r;
+	}
+	Ref4x4 RefPerspective(double fov, double aspect, double zn, double zf)
+	{
+		const double ys = 1.0 / std::tan(fov / 2.0);
+		Ref4x4 r = {};
+		r.m[0][0] = ys / aspect;
+		r.m[1][1] = -ys;
+		r.m[2][2] = zf / (zf - zn);
+		r.m[2][3] = -zf * zn / (zf - zn);
+		r.m[3][2] = 1.0;
+		return r;
+	}
+
+	// Error relative to the magnitude of the reference value, absolute below 1
+	double Error(double value, double ref)
+	{
+		return std::abs(value - ref) / std::max(1.0, std::abs(ref));
+	}
+	double Error(const mth::float4x4& value, const Ref4x4& ref)
+	{
+		double e = 0.0;
+		for (size_t y = 0; y < 4; ++y)
+			for (size_t x = 0; x < 4; ++x)
+				e = std::max(e, Error(value(x, y), ref.m[y][x]));
+		return e;
+	}
+	double Error(const mth::Affine3x4f& value, const Ref4x4& ref)
+	{
+		double e = 0.0;
+		for (size_t y = 0; y < 3; ++y)
+			for (size_t x = 0; x < 4; ++x)
+				e = std::max(e, Error(value(x, y), ref.m[y][x]));
+		return e;
+	}
+	template <size_t S>
+	double Error(const mth::Vector<float, S>& value, const double (&ref)[S])
+	{
+		double e = 0.0;
+		for (size_t i = 0; i < S; ++i)
+			e = std::max(e, Error(value(i), ref[i]));
+		return e;
+	}
+
+	class Checker
+	{
+		bool m_passed = true;
+
+	public:
+		// 'error(i)' returns the error of the i-th result
+		template <typename F>
+		void Check(const char* name, double tolerance, F&& error)
+		{
+			double maxError = 0.0;
+			for (size_t i = 0; i < DATA_SIZE; ++i)
+				maxError = std::max(maxError, error(i));
+			const bool ok = maxError <= tolerance;
+			m_passed &= ok;
+			std::cout << "  " << std::left << std::setw(32) << name << std::right
+				<< " max error " << std::scientific << std::setprecision(2) << maxError
+				<< " (tolerance " << tolerance << ") " << (ok ? "ok" : "FAILED") << std::defaultfloat << '\n';
+		}
+		bool Passed() const { return m_passed; }
+	};
+
+	bool CheckCorrectness(const Data& d)
+	{
+		constexpr double TOLERANCE = 1e-5;
+		constexpr double INVERSE_TOLERANCE = 1e-4;
+		Checker c;
+
+		c.Check("float4 add", TOLERANCE, [&](size_t i) {
+			double ref[4];
+			for (size_t k = 0; k < 4; ++k)
+				ref[k] = double(d.vec4a[i](k)) + d.vec4b[i](k);
+			return Error(d.vec4a[i] + d.vec4b[i], ref);
+		});
+		c.Check("float4 MultiplyAdd", TOLERANCE, [&](size_t i) {
+			double ref[4];
+			for (size_t k = 0; k < 4; ++k)
+				ref[k] = double(d.vec4a[i](k)) * d.vec4b[i](k) + d.vec4c[i](k);
+			return Error(mth::MultiplyAdd(d.vec4a[i], d.vec4b[i], d.vec4c[i]), ref);
+		});
+		c.Check("float3 Dot", TOLERANCE, [&](size_t i) {
+			double ref = 0.0;
+			for (size_t k = 0; k < 3; ++k)
+				ref += double(d.vec3a[i](k)) * d.vec3b[i](k);
+			return Error(mth::Dot(d.vec3a[i], d.vec3b[i]), ref);
+		});
+		c.Check("float3 Normalized", TOLERANCE, [&](size_t i) {
+			const mth::float3& v = d.vec3a[i];
+			const double len = std::sqrt(double(v(0)) * v(0) + double(v(1)) * v(1) + double(v(2)) * v(2));
+			double ref[3] = { v(0) / len, v(1) / len, v(2) / len };
+			return Error(mth::Normalized(v), ref);
+		});
+		c.Check("float4x4 operator*", TOLERANCE, [&](size_t i) {
+			return Error(d.general[i] * d.affineA[i], RefMultiply(ToRef(d.general[i]), ToRef(d.affineA[i])));
+		});
+		c.Check("float4x4 Multiply(a, b, c)", TOLERANCE, [&](size_t i) {
+			mth::float4x4 m;
+			mth::Multiply(m, d.affineA[i], d.affineB[i], d.affineC[i]);
+			return Error(m, RefMultiply(RefMultiply(ToRef(d.affineA[i]), ToRef(d.affineB[i])), ToRef(d.affineC[i])));
+		});
+		c.Check("float4x4 AffineMultiply", TOLERANCE, [&](size_t i) {
+			return Error(mth::AffineMultiply(d.affineA[i], d.affineB[i]), RefMultiply(ToRef(d.affineA[i]), ToRef(d.affineB[i])));
+		});
+		c.Check("Affine3x4f Multiply(a, b, c)", TOLERANCE, [&](size_t i) {
+			mth::Affine3x4f m;
+			mth::Multiply(m, d.affine3x4A[i], d.affine3x4B[i], d.affine3x4C[i]);
+			return Error(m, RefMultiply(RefMultiply(ToRef(d.affine3x4A[i]), ToRef(d.affine3x4B[i])), ToRef(d.affine3x4C[i])));
+		});
+		// 'out' may alias an operand, the way the skeleton accumulates transforms
+		c.Check("Affine3x4f Multiply aliased", TOLERANCE, [&](size_t i) {
+			mth::Affine3x4f m = d.affine3x4A[i];
+			mth::Multiply(m, m, d.affine3x4B[i]);
+			mth::Multiply(m, d.affine3x4C[i], m);
+			return Error(m, RefMultiply(ToRef(d.affine3x4C[i]), RefMultiply(ToRef(d.affine3x4A[i]), ToRef(d.affine3x4B[i]))));
+		});
+		c.Check("float4x4 Inverse", INVERSE_TOLERANCE, [&](size_t i) {
+			return Error(mth::Inverse(d.general[i]), RefInverse(ToRef(d.general[i])));
+		});
+		c.Check("Affine3x4f Inverse", INVERSE_TOLERANCE, [&](size_t i) {
+			return Error(mth::Inverse(d.affine3x4A[i]), RefInverse(ToRef(d.affine3x4A[i])));
+		});
+		c.Check("float4x4 Transpose", 0.0, [&](size_t i) {
+			return Error(mth::Transpose(d.general[i]), RefTranspose(ToRef(d.general[i])));
+		});
+		c.Check("float4x4 Transform", TOLERANCE, [&](size_t i) {
+			const Ref4x4 m = ToRef(d.affineA[i]);
+			const mth::float3& v = d.vec3a[i];
+			double ref[3];
+			for (size_t y = 0; y < 3; ++y)
+				ref[y] = m.m[y][0] * v(0) + m.m[y][1] * v(1) + m.m[y][2] * v(2) + m.m[y][3];
+			return Error(mth::Transform(d.affineA[i], v), ref);
+		});
+		c.Check("Affine3x4f Transform", TOLERANCE, [&](size_t i) {
+			const Ref4x4 m = ToRef(d.affine3x4A[i]);
+			const mth::float3& v = d.vec3a[i];
+			double ref[3];
+			for (size_t y = 0; y < 3; ++y)
+				ref[y] = m.m[y][0] * v(0) + m.m[y][1] * v(1) + m.m[y][2] * v(2) + m.m[y][3];
+			return Error(mth::Transform(d.affine3x4A[i], v), ref);
+		});
+		c.Check("SinCos Float", 1.5e-7, [&](size_t i) {
+			float s, c;
+			mth::SinCos<mth::Precision::Float>(d.angles[i], s, c);
+			return std::max(Error(s, std::sin(double(d.angles[i]))), Error(c, std::cos(double(d.angles[i]))));
+		});
+		c.Check("SinCos Low", 3e-5, [&](size_t i) {
+			float s, c;
+			mth::SinCos<mth::Precision::Low>(d.angles[i], s, c);
+			return std::max(Error(s, std::sin(double(d.angles[i]))), Error(c, std::cos(double(d.angles[i]))));
+		});
+		// large angles only have to stay on the unit circle, non-finite ones have to give NaN
+		const float largeAngles[] = { 1e5f, -1e5f, 3.3e9f, -3.3e9f, 1e10f, 1e20f, -1e30f, 3.4e38f, -3.4e38f };
+		const float nonFiniteAngles[] = { NAN, -NAN, INFINITY, -INFINITY };
+		auto unitCircleError = [&](auto sinCos, size_t i) {
+			float s, c;
+			sinCos(largeAngles[i % std::size(largeAngles)], s, c);
+			const double e = std::max({ std::abs(double(s)) - 1.0, std::abs(double(c)) - 1.0, std::abs(double(s) * s + double(c) * c - 1.0) });
+			return std::isfinite(e) ? e : INFINITY;
+		};
+		auto nonFiniteError = [&](auto sinCos, size_t i) {
+			float s, c;
+			sinCos(nonFiniteAngles[i % std::size(nonFiniteAngles)], s, c);
+			return std::isnan(s) && std::isnan(c) ? 0.0 : 1.0;
+		};
+		const auto sinCosFloat = [](float a, float& s, float& c) { mth::SinCos<mth::Precision::Float>(a, s, c); };
+		const auto sinCosLow = [](float a, float& s, float& c) { mth::SinCos<mth::Precision::Low>(a, s, c); };
+		c.Check("SinCos Float large angles", 1e-6, [&](size_t i) { return unitCircleError(sinCosFloat, i); });
+		c.Check("SinCos Low large angles", 1e-4, [&](size_t i) { return unitCircleError(sinCosLow, i); });
+		c.Check("SinCos Float non-finite", 0.0, [&](size_t i) { return nonFiniteError(sinCosFloat, i); });
+		c.Check("SinCos Low non-finite", 0.0, [&](size_t i) { return nonFiniteError(sinCosLow, i); });
+		c.Check("Rotation3x3", TOLERANCE, [&](size_t i) {
+			const mth::float3& r = d.rotations[i];
+			const double cp = std::cos(double(r(0))), sp = std::sin(double(r(0)));
+			const double cy = std::cos(double(r(1))), sy = std::sin(double(r(1)));
+			const double cr = std::cos(double(r(2))), sr = std::sin(double(r(2)));
+			// yaw (around y) * pitch (around x) * roll (around z)
+			const Ref4x4 ry = { { { cy, 0, sy, 0 }, { 0, 1, 0, 0 }, { -sy, 0, cy, 0 }, { 0, 0, 0, 1 } } };
+			const Ref4x4 rx = { { { 1, 0, 0, 0 }, { 0, cp, -sp, 0 }, { 0, sp, cp, 0 }, { 0, 0, 0, 1 } } };
+			const Ref4x4 rz = { { { cr, -sr, 0, 0 }, { sr, cr, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+			return Error(mth::Rotation4x4(r), RefMultiply(RefMultiply(ry, rx), rz));
+		});
+		c.Check("PerspectiveFOV", TOLERANCE, [&](size_t i) {
+			return Error(mth::PerspectiveFOV(d.fov[i], 16.0f / 9.0f, 0.1f, 1000.0f), RefPerspective(d.fov[i], 16.0f / 9.0f, 0.1f, 1000.0f));
+		});
+		return c.Passed();
+	}
+
+	// Runs 'op(i)' for every input, doubling the repetitions until a run takes
+	// at least MIN_RUN_TIME, then keeps the fastest of RUN_COUNT runs
+	template <typename T, typename F>
+	void Benchmark(const char* name, std::vector<T>& out, F&& op)
+	{
+		using clock = std::chrono::steady_clock;
+		auto run = [&](size_t reps) {
+			const auto start = clock::now();
+			for (size_t r = 0; r < reps; ++r)
+			{
+				for (size_t i = 0; i < DATA_SIZE; ++i)
+					op(i);
+				Escape(out.data());
+			}
+			return std::chrono::duration<double>(clock::now() - start).count();
+		};
+
+		size_t reps = 1;
+		while (run(reps) < MIN_RUN_TIME)
+			reps *= 2;
+		double best = run(reps);
+		for (int i = 1; i < RUN_COUNT; ++i)
+			best = std::min(best, run(reps));
+
+		const double nsPerOp = best * 1e9 / double(reps * DATA_SIZE);
+		std::cout << "  " << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(10) << nsPerOp << " ns/op"
+			<< std::setw(12) << 1e3 / nsPerOp << " Mop/s" << std::defaultfloat << '\n';
+	}
+
+	void RunBenchmarks(const Data& d)
+	{
+		std::vector<float> scalars(DATA_SIZE);
+		std::vector<float> scalars2(DATA_SIZE);
+		std::vector<mth::float3> vec3s(DATA_SIZE);
+		std::vector<mth::float4> vec4s(DATA_SIZE);
+		std::vector<mth::float4x4> matrices(DATA_SIZE);
+		std::vector<mth::Affine3x4f> affines(DATA_SIZE);
+
+		Benchmark("float4 add", vec4s, [&](size_t i) { vec4s[i] = d.vec4a[i] + d.vec4b[i]; });
+		Benchmark("float4 MultiplyAdd", vec4s, [&](size_t i) { vec4s[i] = mth::MultiplyAdd(d.vec4a[i], d.vec4b[i], d.vec4c[i]); });
+		Benchmark("float3 Dot", scalars, [&](size_t i) { scalars[i] = mth::Dot(d.vec3a[i], d.vec3b[i]); });
+		Benchmark("float3 Normalized", vec3s, [&](size_t i) { vec3s[i] = mth::Normalized(d.vec3a[i]); });
+		Benchmark("float4x4 operator*", matrices, [&](size_t i) { matrices[i] = d.general[i] * d.affineA[i]; });
+		Benchmark("float4x4 a * b * c", matrices, [&](size_t i) { matrices[i] = d.affineA[i] * d.affineB[i] * d.affineC[i]; });
+		Benchmark("float4x4 Multiply(a, b, c)", matrices, [&](size_t i) { mth::Multiply(matrices[i], d.affineA[i], d.affineB[i], d.affineC[i]); });
+		Benchmark("float4x4 AffineMultiply", matrices, [&](size_t i) { mth::AffineMultiply(matrices[i], d.affineA[i], d.affineB[i]); });
+		Benchmark("float4x4 AffineMultiply(a, b, c)", matrices, [&](size_t i) { mth::AffineMultiply(matrices[i], d.affineA[i], d.affineB[i], d.affineC[i]); });
+		Benchmark("Affine3x4f a * b * c", affines, [&](size_t i) { affines[i] = d.affine3x4A[i] * d.affine3x4B[i] * d.affine3x4C[i]; });
+		Benchmark("Affine3x4f Multiply(a, b, c)", affines, [&](size_t i) { mth::Multiply(affines[i], d.affine3x4A[i], d.affine3x4B[i], d.affine3x4C[i]); });
+		Benchmark("float4x4 Inverse", matrices, [&](size_t i) { matrices[i] = mth::Inverse(d.general[i]); });
+		Benchmark("Affine3x4f Inverse", affines, [&](size_t i) { affines[i] = mth::Inverse(d.affine3x4A[i]); });
+		Benchmark("float4x4 Transpose", matrices, [&](size_t i) { matrices[i] = mth::Transpose(d.general[i]); });
+		Benchmark("float4x4 Transform", vec3s, [&](size_t i) { vec3s[i] = mth::Transform(d.affineA[i], d.vec3a[i]); });
+		Benchmark("Affine3x4f Transform", vec3s, [&](size_t i) { vec3s[i] = mth::Transform(d.affine3x4A[i], d.vec3a[i]); });
+		Benchmark("std::sin + std::cos", scalars, [&](size_t i) {
+			scalars[i] = std::sin(d.angles[i]);
+			scalars2[i] = std::cos(d.angles[i]);
+		});
+		Benchmark("SinCos Float", scalars, [&](size_t i) { mth::SinCos<mth::Precision::Float>(d.angles[i], scalars[i], scalars2[i]); });
+		Benchmark("SinCos Low", scalars, [&](size_t i) { mth::SinCos<mth::Precision::Low>(d.angles[i], scalars[i], scalars2[i]); });
+		Benchmark("SinCos Float batched", scalars, [&](size_t i) {
+			if (i == 0)
+				mth::SinCos<mth::Precision::Float>(d.angles.data(), scalars.data(), scalars2.data(), DATA_SIZE);
+		});
+		Benchmark("Rotation3x3", matrices, [&](size_t i) { matrices[i] = mth::Rotation4x4(d.rotations[i]); });
+		Benchmark("RotationCamera3x3", matrices, [&](size_t i) { matrices[i] = mth::Matrix<float, 4, 4>(mth::RotationCamera3x3(d.rotations[i])); });
+		Benchmark("PerspectiveFOV", matrices, [&](size_t i) { matrices[i] = mth::PerspectiveFOV(d.fov[i], 16.0f / 9.0f, 0.1f, 1000.0f); });
+	}
+}
+
+int main()
+{
+	std::cout << "mth benchmark [" << BENCH_ISA << "]\n";
+	if (!IsaSupported())
+	{
+		std::cout << "  skipped, the CPU does not support this instruction set\n";
+		return 0;
+	}
+
+	const Data data = MakeData();
+
+	std::cout << "correctness:\n";
+	if (!CheckCorrectness(data))
+	{
+		std::cerr << "mth benchmark [" << BENCH_ISA << "]: correctness check failed" << std::endl;
+		return 1;
+	}
+
+	std::cout << "performance:\n";
+	RunBenchmarks(data);
+	return 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "animator.hpp"
+
+namespace democollection
+{
+	// Mixes the motions of several layers into one pose. Every layer plays one
+	// motion at a time and crossfades when it is given a new one; layers are
+	// applied in order, either replacing the pose so far or adding to it, each
+	// with a weight and a per bone mask. All pose buffers are allocated up front.
+	class AnimationBlender
+	{
+	public:
+		enum class LayerMode
+		{
+			Override,	// blends from the pose of the layers below towards this layer's pose
+			Additive	// applies this layer's pose on top of the layers below
+		};
+
+	private:
+		struct Clip
+		{
+			std::unique_ptr<Animator> animator;
+			float startTime;
+		};
+
+		struct Layer
+		{
+			LayerMode mode;
+			float weight;
+			std::vector<float> mask;
+			Clip current;
+			Clip previous;		// fading out
+			float fadeStart;
+			float fadeDuration;
+		};
+
+	private:
+		const Skeleton& m_skeleton;
+		std::vector<Layer> m_layers;
+		std::vector<float> m_fullMask;
+		Pose m_result;
+		Pose m_layerPose;
+		Pose m_clipPose;
+
+	private:
+		static float ClipFrame(const Clip& clip, float time);
+		static void SampleClip(Clip& clip, float time, Pose& pose);
+
+	public:
+		// Starts with a single override layer that drives every bone
+		explicit AnimationBlender(const Skeleton& skeleton);
+
+		// Mask weight 1 for 'bone' and everything below it, 0 for the rest
+		static std::vector<float> MaskFromBone(const Skeleton& skeleton, int bone);
+
+		// Returns the index of the new layer; an empty mask drives every bone
+		size_t AddLayer(LayerMode mode, float weight = 1.0f, std::vector<float> mask = {});
+		inline void SetLayerWeight(size_t layer, float weight) { m_layers[layer].weight = weight; }
+
+		// Starts 'motion' from its first frame at 'time' seconds and crossfades to it over
+		// 'fadeDuration'; a null motion fades the layer out
+		void Play(size_t layer, std::shared_ptr<const CompressedMotion> motion, float time, float fadeDuration = 0.0f);
+
+		// Evaluates all layers at 'time' seconds and writes the result into the local transforms
+		void Evaluate(float time, Skeleton& skeleton);
+
+		// The motion and its looped frame at 'time' if the pose is just that one clip at full
+		// weight, so it depends on nothing but the motion, the frame and the skeleton; otherwise null
+		const CompressedMotion* SingleClip(float time, float& frame) const;
+		// Evaluates the single clip at 'frame'; only valid while SingleClip returns a motion
+		void EvaluateFrame(float frame, Skeleton& skeleton);
+
+		inline size_t LayerCount() const { return m_layers.size(); }
+		inline const Pose& Result() const { return m_result; }
+	};
+}
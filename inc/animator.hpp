@@ -0,0 +1,59 @@
+#pragma once
+
+#include "compressedmotion.hpp"
+#include "pose.hpp"
+
+#include <memory>
+
+namespace democollection
+{
+	// Plays a CompressedMotion on a Skeleton. Tracks are matched to bones by name
+	// once; each track remembers the keyframe used by the previous sample, so
+	// playing forward finds the next keyframe in constant time and only jumps
+	// fall back to a binary search. Sampling gathers the two keyframes of every
+	// track and decodes all of them in one vectorized pass.
+	class Animator
+	{
+		struct Binding
+		{
+			uint32_t track;
+			uint32_t bone;
+			uint32_t cursor;	// last keyframe at or before the previous sample
+		};
+
+		// Inputs and results of the decode pass, one element per binding in every array
+		struct DecodeBuffers
+		{
+			std::vector<uint32_t> rotations[2][3];		// packed rotations of the keyframes before and after the sample
+			std::vector<uint32_t> translations[2][3];
+			std::vector<float> translationMin[3];
+			std::vector<float> translationScale[3];
+			std::vector<float> weights[4];				// curve values of the x, y, z translation and the rotation
+			std::vector<float> outRotations[4];
+			std::vector<float> outTranslations[3];
+
+			void Resize(size_t count);
+		};
+
+	private:
+		std::shared_ptr<const CompressedMotion> m_motion;
+		std::vector<Binding> m_bindings;
+		DecodeBuffers m_decode;
+
+	private:
+		static uint32_t FindKeyframe(const CompressedMotion::Keyframe* keyframes, uint32_t count, float frame, uint32_t cursor);
+		// Interpolates every bound track at 'frame' into the out arrays of m_decode
+		void Decode(float frame);
+
+	public:
+		Animator(const Skeleton& skeleton, std::shared_ptr<const CompressedMotion> motion);
+
+		// Writes the pose at 'frame' into the local transforms of the animated bones
+		void Sample(float frame, Skeleton& skeleton);
+		// Same into a pose of the skeleton; bones without a track are left as they are
+		void Sample(float frame, Pose& pose);
+
+		inline const CompressedMotion& GetMotion() const { return *m_motion; }
+		inline size_t BoundTrackCount() const { return m_bindings.size(); }
+	};
+}
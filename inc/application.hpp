@@ -3,6 +3,7 @@
 #include "vk/model.hpp"
 #include "camera.hpp"
 #include "orbitcontroller.hpp"
+#include "jobsystem.hpp"
 #include <chrono>
 
 namespace democollection
@@ -13,20 +14,40 @@ namespace democollection
 		std::unique_ptr<vk::Graphics> m_graphics;
 		std::unique_ptr<vk::UniformBuffer> m_sceneBufferVs;
 		std::unique_ptr<vk::UniformBuffer> m_sceneBufferFs;
-		std::unique_ptr<vk::Model> m_model;
+		std::unique_ptr<vk::PaletteArena> m_paletteArena;
+		std::unique_ptr<vk::GeometryArena> m_geometryArena;
+		std::unique_ptr<vk::MaterialArena> m_materialArena;
+		std::vector<std::unique_ptr<vk::Model>> m_models;
+		vk::PoseCache m_poseCache;
+		JobSystem m_jobs;
+		size_t m_animationStart;
+		std::vector<std::shared_ptr<const CompressedMotion>> m_motions;
+		size_t m_currentMotion;
+		bool m_motionSwitchRequested;
+		bool m_zeroAnimationBudget;		// to check what models that miss the budget draw
 		Camera m_camera;
 		OrbitController m_camController;
 		std::chrono::steady_clock::time_point m_startTime;
 		std::chrono::steady_clock::time_point m_prevFrameTime;
 
+		// Time animation may take per frame; models that do not fit keep their last pose and go first next frame
+		static constexpr std::chrono::microseconds ANIMATION_BUDGET{4000};
+		static constexpr float MOTION_CROSSFADE_TIME = 0.5f;
+		// The crowd plays its motion at this many time offsets, instances in the same phase share their pose
+		static constexpr size_t CROWD_PHASES = 4;
+		// Rounding of the animation time of cached poses in motion frames
+		static constexpr float POSE_CACHE_FRAME_STEP = 0.25f;
+
 	private:
 		void Update();
 		void Render();
+		void PrintMemoryUsage() const;
 
 		void Resize(int width, int height);
 		void MouseMove(double x, double y);
 		void MouseButton(int button, int action, int modifier);
 		void Scroll(double x, double y);
+		void Key(int key, int scancode, int action, int modifier);
 
 	public:
 		Application();
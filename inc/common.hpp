@@ -51,5 +51,6 @@ namespace democollection
 	void SaveProgramFolder(const char programPath[]);
 	const std::string& GetProgramFolder();
 	std::string GetFolderName(const char filename[]);
+	std::string ShiftJisToUtf8(const char* text, size_t length);
 	std::vector<char> ReadFile(const char* filename);
 }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "motion.hpp"
+
+namespace democollection
+{
+	// Resident form of a Motion, a third of its size. Rotations keep the three
+	// smallest components at 15 bits each, translations are 16 bit fractions of
+	// the range of their track and curve control points are stored as the bytes
+	// VMD files contain. Keyframes of all tracks share one array.
+	class CompressedMotion
+	{
+	public:
+		struct Keyframe
+		{
+			uint32_t frame;
+			// smallest three; bit 15 of the first two holds the index of the dropped component
+			uint16_t rotation[3];
+			uint16_t translation[3];
+			uint8_t curves[16];		// x1, y1, x2, y2 of the x, y, z translation and rotation curves, times 127
+		};
+		static_assert(sizeof(Keyframe) == 32);
+
+		struct Track
+		{
+			std::string boneName;
+			uint32_t firstKeyframe;
+			uint32_t keyframeCount;
+			mth::float3 translationMin;
+			mth::float3 translationScale;	// translation = min + scale * quantized
+		};
+
+		static constexpr float ROTATION_RANGE = 0.70710678f;	// no other component can be above 1 / sqrt(2)
+		static constexpr float ROTATION_MAX = 32767.0f;
+		static constexpr float TRANSLATION_MAX = 65535.0f;
+		static constexpr float CURVE_MAX = 127.0f;
+
+	private:
+		std::vector<Track> m_tracks;
+		std::vector<Keyframe> m_keyframes;
+		uint32_t m_lastFrame;
+
+	public:
+		static void EncodeRotation(const mth::Quaternionf& q, uint16_t out[3]);
+		static mth::Quaternionf DecodeRotation(const uint16_t packed[3]);
+		static Bezier DecodeCurve(const Keyframe& keyframe, size_t curve);
+		static mth::float3 DecodeTranslation(const Track& track, const Keyframe& keyframe);
+
+		explicit CompressedMotion(const Motion& motion);
+
+		// Bytes in use, for comparing against the source
+		size_t MemorySize() const;
+
+		inline const std::vector<Track>& Tracks() const { return m_tracks; }
+		inline const Keyframe* Keyframes(const Track& track) const { return m_keyframes.data() + track.firstKeyframe; }
+		inline uint32_t LastFrame() const { return m_lastFrame; }
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "skeleton.hpp"
+
+namespace democollection
+{
+	// Bone of an IK chain that the solver may rotate
+	struct IkLink
+	{
+		uint32_t bone;
+		bool hasLimits;
+		mth::float3 minAngle;	// euler angles in radians relative to the parent, rotation order x, y, z
+		mth::float3 maxAngle;
+	};
+
+	// Moves 'target' onto the position of 'ikBone' by rotating the links, links
+	// are ordered from the closest to the target up the hierarchy
+	struct IkChain
+	{
+		uint32_t ikBone;
+		uint32_t target;
+		uint32_t loopCount;
+		float limitAngle;		// maximum rotation of a link per iteration
+		std::vector<IkLink> links;
+	};
+
+	// Cyclic coordinate descent over the IK chains of a skeleton. Everything the
+	// solver needs per frame is flattened at construction, so Solve does not
+	// allocate.
+	class IkSolver
+	{
+		struct Link
+		{
+			uint32_t bone;
+			uint32_t pathIndex;	// position of the bone in m_path
+			bool hasLimits;
+			mth::float3 minAngle;
+			mth::float3 maxAngle;
+		};
+
+		struct Chain
+		{
+			uint32_t ikBone;
+			uint32_t target;
+			uint32_t loopCount;
+			float limitAngle;
+			uint32_t firstLink;
+			uint32_t linkCount;
+			uint32_t firstPathBone;	// bones from the last link down to the target, parent first
+			uint32_t pathCount;
+		};
+
+	private:
+		std::vector<Link> m_links;
+		std::vector<uint32_t> m_path;
+		std::vector<Chain> m_chains;
+
+	private:
+		static void ClampRotation(mth::Affine3x4f& local, const mth::float3& minAngle, const mth::float3& maxAngle);
+
+	public:
+		// Squared distance between target and IK bone at which a chain counts as solved
+		static constexpr float TOLERANCE = 1e-8f;
+
+		IkSolver() = default;
+		// Chains whose links are not ancestors of their target are dropped
+		IkSolver(const Skeleton& skeleton, const std::vector<IkChain>& chains);
+
+		// Expects up to date global transforms and leaves them up to date;
+		// 'world' has to be the transform the globals were computed with
+		void Solve(Skeleton& skeleton, const mth::Affine3x4f& world = mth::Affine3x4f()) const;
+
+		inline bool Empty() const { return m_chains.empty(); }
+		inline size_t ChainCount() const { return m_chains.size(); }
+	};
+}
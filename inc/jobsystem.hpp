@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace democollection
+{
+	// Fixed pool of worker threads running one parallel loop at a time. The
+	// calling thread takes part in the loop, so a pool without workers simply
+	// runs everything inline.
+	class JobSystem
+	{
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		void operator=(const JobSystem&) = delete;
+		void operator=(JobSystem&&) = delete;
+
+	private:
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		const std::function<void(size_t)>* m_job;
+		size_t m_jobCount;
+		std::atomic<size_t> m_nextJob;
+		std::atomic<size_t> m_finishedJobs;
+		uint32_t m_activeWorkers;
+		uint64_t m_generation;
+		bool m_quit;
+
+	private:
+		void WorkerLoop();
+		void Work(const std::function<void(size_t)>& job, size_t count);
+
+	public:
+		// 0 threads means one less than the number of hardware threads
+		explicit JobSystem(uint32_t threadCount = 0);
+		~JobSystem();
+
+		// Calls job(i) for every i in [0, count) and returns when all calls finished
+		void ParallelFor(size_t count, const std::function<void(size_t)>& job);
+
+		inline uint32_t WorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+	};
+}
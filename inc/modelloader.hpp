@@ -22,6 +22,7 @@ namespace democollection
 		inline const std::vector<vk::Vertex>& Vertices() const { return vertices; }
 		inline const std::vector<uint32_t>& Indices() const { return indices; }
 		inline const std::vector<MaterialData>& Materials() const { return materials; }
-		inline const std::vector<vk::Bone>& Skeleton() const { return skeleton; }
+		inline const democollection::Skeleton& Skeleton() const { return skeleton; }
+		inline const std::vector<IkChain>& IkChains() const { return ikChains; }
 	};
 }
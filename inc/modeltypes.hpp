@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "iksolver.hpp"
 #include "vk/types.hpp"
 
 namespace democollection
@@ -18,6 +19,7 @@ namespace democollection
 		std::vector<vk::Vertex> vertices;
 		std::vector<uint32_t> indices;
 		std::vector<MaterialData> materials;
-		std::vector<vk::Bone> skeleton;
+		Skeleton skeleton;
+		std::vector<IkChain> ikChains;
 	};
 }
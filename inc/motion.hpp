@@ -0,0 +1,45 @@
+#pragma once
+
+#include "mth/quaternion.hpp"
+
+#include <string>
+#include <vector>
+
+namespace democollection
+{
+	// Interpolation curve of a keyframe: a cubic Bézier from (0, 0) to (1, 1)
+	// with control points (x1, y1) and (x2, y2), all in [0, 1]
+	struct Bezier
+	{
+		float x1 = 0.25f;
+		float y1 = 0.25f;
+		float x2 = 0.75f;
+		float y2 = 0.75f;
+
+		// Interpolation weight at 'x', the fraction of time passed between the keyframes
+		float Evaluate(float x) const;
+		inline bool IsLinear() const { return x1 == y1 && x2 == y2; }
+	};
+
+	struct BoneKeyframe
+	{
+		uint32_t frame;
+		mth::float3 translation;
+		mth::Quaternionf rotation;
+		Bezier curves[4];	// x, y, z translation and rotation, used when interpolating towards this keyframe
+	};
+
+	struct BoneTrack
+	{
+		std::string boneName;
+		std::vector<BoneKeyframe> keyframes;	// sorted by frame
+	};
+
+	struct Motion
+	{
+		static constexpr float FRAMES_PER_SECOND = 30.0f;
+
+		std::vector<BoneTrack> boneTracks;
+		uint32_t lastFrame = 0;
+	};
+}
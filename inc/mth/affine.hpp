@@ -0,0 +1,155 @@
+#pragma once
+
+#include "linalg.hpp"
+
+namespace democollection::mth
+{
+	// Affine transform stored as the top three rows of a 4x4 matrix; the implicit
+	// last row is (0, 0, 0, 1). The memory layout (three rows of four) matches a
+	// GLSL mat3x4, which has to be applied as 'vec4 * mat3x4' in shaders.
+	template <typename T>
+	class Affine3x4
+	{
+		Matrix<T, 4, 3> m_mat;
+
+	public:
+		Affine3x4()
+			: m_mat(
+				T{1}, T{0}, T{0}, T{0},
+				T{0}, T{1}, T{0}, T{0},
+				T{0}, T{0}, T{1}, T{0})
+		{}
+		explicit Affine3x4(const Matrix<T, 4, 4>& m)
+			: m_mat(m)
+		{}
+		Affine3x4(const Matrix<T, 3, 3>& linear, const Vector<T, 3>& translation)
+		{
+			for (size_t y = 0; y < 3; ++y)
+			{
+				for (size_t x = 0; x < 3; ++x)
+					m_mat(x, y) = linear(x, y);
+				m_mat(3, y) = translation(y);
+			}
+		}
+
+		inline const T& operator()(size_t x, size_t y) const { return m_mat(x, y); }
+		inline T& operator()(size_t x, size_t y) { return m_mat(x, y); }
+
+		Matrix<T, 3, 3> Linear() const { return Matrix<T, 3, 3>(m_mat); }
+		Vector<T, 3> Translation() const { return m_mat.ColToVector(3); }
+		Matrix<T, 4, 4> ToMatrix() const { return Matrix<T, 4, 4>(m_mat); }
+
+		Affine3x4<T> operator*(const Affine3x4<T>& rhs) const
+		{
+			Affine3x4<T> r;
+			Multiply(r, *this, rhs);
+			return r;
+		}
+		Affine3x4<T>& operator*=(const Affine3x4<T>& rhs)
+		{
+			return *this = *this * rhs;
+		}
+	};
+
+	// Like the fused products in linalg.hpp, the result is built in a local and assigned
+	// once: 'out' may alias the operands, and is only written, so it may live in mapped GPU memory
+	template <typename T>
+	void Multiply(Affine3x4<T>& out, const Affine3x4<T>& lhs, const Affine3x4<T>& rhs)
+	{
+		Affine3x4<T> m;
+		for (size_t y = 0; y < 3; ++y)
+		{
+			for (size_t x = 0; x < 3; ++x)
+				m(x, y) = lhs(0, y) * rhs(x, 0) + lhs(1, y) * rhs(x, 1) + lhs(2, y) * rhs(x, 2);
+			m(3, y) = lhs(0, y) * rhs(3, 0) + lhs(1, y) * rhs(3, 1) + lhs(2, y) * rhs(3, 2) + lhs(3, y);
+		}
+		out = m;
+	}
+	// out = a * b * c, evaluated one row at a time
+	template <typename T>
+	void Multiply(Affine3x4<T>& out, const Affine3x4<T>& a, const Affine3x4<T>& b, const Affine3x4<T>& c)
+	{
+		Affine3x4<T> m;
+		for (size_t y = 0; y < 3; ++y)
+		{
+			T row[4];
+			for (size_t x = 0; x < 4; ++x)
+				row[x] = a(0, y) * b(x, 0) + a(1, y) * b(x, 1) + a(2, y) * b(x, 2);
+			row[3] += a(3, y);
+			for (size_t x = 0; x < 3; ++x)
+				m(x, y) = row[0] * c(x, 0) + row[1] * c(x, 1) + row[2] * c(x, 2);
+			m(3, y) = row[0] * c(3, 0) + row[1] * c(3, 1) + row[2] * c(3, 2) + row[3];
+		}
+		out = m;
+	}
+	template <typename T>
+	Affine3x4<T> Inverse(const Affine3x4<T>& m)
+	{
+		const T c00 = m(1, 1) * m(2, 2) - m(2, 1) * m(1, 2);
+		const T c01 = m(2, 1) * m(0, 2) - m(0, 1) * m(2, 2);
+		const T c02 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+		const T oneoverdet = T{1} / (m(0, 0) * c00 + m(1, 0) * c01 + m(2, 0) * c02);
+
+		Affine3x4<T> r;
+		r(0, 0) = c00 * oneoverdet;
+		r(0, 1) = c01 * oneoverdet;
+		r(0, 2) = c02 * oneoverdet;
+		r(1, 0) = (m(2, 0) * m(1, 2) - m(1, 0) * m(2, 2)) * oneoverdet;
+		r(1, 1) = (m(0, 0) * m(2, 2) - m(2, 0) * m(0, 2)) * oneoverdet;
+		r(1, 2) = (m(1, 0) * m(0, 2) - m(0, 0) * m(1, 2)) * oneoverdet;
+		r(2, 0) = (m(1, 0) * m(2, 1) - m(2, 0) * m(1, 1)) * oneoverdet;
+		r(2, 1) = (m(2, 0) * m(0, 1) - m(0, 0) * m(2, 1)) * oneoverdet;
+		r(2, 2) = (m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1)) * oneoverdet;
+		for (size_t y = 0; y < 3; ++y)
+			r(3, y) = -(r(0, y) * m(3, 0) + r(1, y) * m(3, 1) + r(2, y) * m(3, 2));
+		return r;
+	}
+	// Inverse of a transform that only contains rotation and translation
+	template <typename T>
+	Affine3x4<T> InverseRigid(const Affine3x4<T>& m)
+	{
+		Affine3x4<T> r;
+		for (size_t y = 0; y < 3; ++y)
+			for (size_t x = 0; x < 3; ++x)
+				r(x, y) = m(y, x);
+		for (size_t y = 0; y < 3; ++y)
+			r(3, y) = -(r(0, y) * m(3, 0) + r(1, y) * m(3, 1) + r(2, y) * m(3, 2));
+		return r;
+	}
+	template <typename T>
+	Vector<T, 3> Transform(const Affine3x4<T>& m, const Vector<T, 3>& v)
+	{
+		return Vector<T, 3>(
+			m(0, 0) * v(0) + m(1, 0) * v(1) + m(2, 0) * v(2) + m(3, 0),
+			m(0, 1) * v(0) + m(1, 1) * v(1) + m(2, 1) * v(2) + m(3, 1),
+			m(0, 2) * v(0) + m(1, 2) * v(1) + m(2, 2) * v(2) + m(3, 2));
+	}
+	template <typename T>
+	Vector<T, 3> TransformDirection(const Affine3x4<T>& m, const Vector<T, 3>& v)
+	{
+		return Vector<T, 3>(
+			m(0, 0) * v(0) + m(1, 0) * v(1) + m(2, 0) * v(2),
+			m(0, 1) * v(0) + m(1, 1) * v(1) + m(2, 1) * v(2),
+			m(0, 2) * v(0) + m(1, 2) * v(1) + m(2, 2) * v(2));
+	}
+
+	template <typename T>
+	Affine3x4<T> Translation3x4(const Vector<T, 3>& t)
+	{
+		return Affine3x4<T>(Identity<T, 3>(), t);
+	}
+	template <typename T>
+	Affine3x4<T> TranslationInv3x4(const Vector<T, 3>& t)
+	{
+		return Affine3x4<T>(Identity<T, 3>(), Vector<T, 3>(-t(0), -t(1), -t(2)));
+	}
+
+	template <typename T>
+	std::ostream& operator<<(std::ostream& os, const Affine3x4<T>& m)
+	{
+		return os << m.ToMatrix();
+	}
+
+	using Affine3x4f = Affine3x4<float>;
+	using Affine3x4d = Affine3x4<double>;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "affine.hpp"
+
+#include <type_traits>
+
+namespace democollection::mth
+{
+	// GLSL block layouts. A struct that is memcpy'd into a uniform (std140) or
+	// storage (std430) buffer has to place every member where GLSL expects it.
+	// The mth types are not over-aligned themselves (float3 stays 12 bytes, so
+	// vertex data remains tightly packed), members that need more alignment get
+	// it with alignas(LayoutAlignment<...>), and MatchesLayout checks the result
+	// at compile time.
+	enum class Layout
+	{
+		Std140,
+		Std430
+	};
+
+	constexpr size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Base alignment and size of a type as GLSL sees it in a block
+	template <Layout L, typename T, typename = void>
+	struct LayoutInfo;
+
+	template <Layout L, typename T>
+	struct LayoutInfo<L, T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>>
+	{
+		static constexpr size_t alignment = sizeof(T);
+		static constexpr size_t size = sizeof(T);
+	};
+	template <Layout L, typename T, size_t S>
+	struct LayoutInfo<L, Vector<T, S>>
+	{
+		static constexpr size_t alignment = (S == 1 ? 1 : S == 2 ? 2 : 4) * sizeof(T);
+		static constexpr size_t size = S * sizeof(T);
+	};
+	// Arrays: in std140 the stride is rounded up to the alignment of a vec4
+	template <Layout L, typename T, size_t N>
+	struct LayoutInfo<L, T[N]>
+	{
+		static constexpr size_t alignment = L == Layout::Std140 ? AlignUp(LayoutInfo<L, T>::alignment, 16) : LayoutInfo<L, T>::alignment;
+		static constexpr size_t stride = AlignUp(LayoutInfo<L, T>::size, alignment);
+		static constexpr size_t size = stride * N;
+	};
+	// A Matrix is Y rows of X elements in memory, which GLSL reads as an array of Y vectors
+	template <Layout L, typename T, size_t X, size_t Y>
+	struct LayoutInfo<L, Matrix<T, X, Y>> : LayoutInfo<L, Vector<T, X>[Y]>
+	{};
+	template <Layout L, typename T>
+	struct LayoutInfo<L, Affine3x4<T>> : LayoutInfo<L, Matrix<T, 4, 3>>
+	{};
+
+	template <Layout L, typename T>
+	inline constexpr size_t LayoutAlignment = LayoutInfo<L, T>::alignment;
+	// Distance between consecutive elements of a T[] in a block
+	template <Layout L, typename T>
+	inline constexpr size_t LayoutStride = LayoutInfo<L, T[1]>::stride;
+
+	// True if a type has the same size in C++ and in the block, so it can be copied as is
+	template <Layout L, typename T>
+	inline constexpr bool IsLayoutCompatible = sizeof(T) == LayoutInfo<L, T>::size;
+
+	// Checks that 'S', with members of the given types at the given offsets, matches
+	// the GLSL layout of the same block, including its size. Nested structs are not
+	// supported. Usage:
+	//   static_assert(MatchesLayout<Layout::Std140, Block, float4, float>(offsetof(Block, a), offsetof(Block, b)));
+	template <Layout L, typename S, typename... Members, typename... Offsets>
+	constexpr bool MatchesLayout(Offsets... offsets)
+	{
+		static_assert(sizeof...(Members) == sizeof...(Offsets), "one offset is needed for every member");
+
+		const bool compatible[] = { IsLayoutCompatible<L, Members>... };
+		const size_t alignments[] = { LayoutInfo<L, Members>::alignment... };
+		const size_t sizes[] = { LayoutInfo<L, Members>::size... };
+		const size_t actualOffsets[] = { static_cast<size_t>(offsets)... };
+
+		size_t offset = 0;
+		size_t structAlignment = L == Layout::Std140 ? 16 : 1;
+		for (size_t i = 0; i < sizeof...(Members); ++i)
+		{
+			offset = AlignUp(offset, alignments[i]);
+			if (!compatible[i] || offset != actualOffsets[i])
+				return false;
+			offset += sizes[i];
+			structAlignment = std::max(structAlignment, alignments[i]);
+		}
+		return sizeof(S) == AlignUp(offset, structAlignment);
+	}
+}
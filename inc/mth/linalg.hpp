@@ -1,5 +1,7 @@
 #pragma once
 
+#include "trig.hpp"
+
 #include <cmath>
 #include <algorithm>
 #include <initializer_list>
@@ -192,6 +194,14 @@ namespace democollection::mth
 			dot += lhs(i) * rhs(i);
 		return dot;
 	}
+	template <typename T>
+	Vector<T, 3> Cross(const Vector<T, 3>& lhs, const Vector<T, 3>& rhs)
+	{
+		return Vector<T, 3>(
+			lhs(1) * rhs(2) - lhs(2) * rhs(1),
+			lhs(2) * rhs(0) - lhs(0) * rhs(2),
+			lhs(0) * rhs(1) - lhs(1) * rhs(0));
+	}
 	template <typename T, size_t S>
 	T LengthSquare(const Vector<T, S>& v)
 	{
@@ -509,6 +519,98 @@ namespace democollection::mth
 		return m;
 	}
 
+	// Fused operations, they skip the intermediate matrices of chained operator*.
+	// The result is built in a local and assigned to 'out' once, so 'out' may alias
+	// the operands and the compiler does not have to reload them after every store.
+	template <typename T, size_t S>
+	Vector<T, S> MultiplyAdd(const Vector<T, S>& a, const Vector<T, S>& b, const Vector<T, S>& c)
+	{
+		Vector<T, S> r;
+		for (size_t i = 0; i < S; ++i)
+			r(i) = a(i) * b(i) + c(i);
+		return r;
+	}
+	template <typename T, size_t S>
+	Vector<T, S> MultiplyAdd(const Vector<T, S>& a, const T& b, const Vector<T, S>& c)
+	{
+		Vector<T, S> r;
+		for (size_t i = 0; i < S; ++i)
+			r(i) = a(i) * b + c(i);
+		return r;
+	}
+	// out = a * b * c, evaluated one row at a time
+	template <typename T, size_t S>
+	void Multiply(Matrix<T, S, S>& out, const Matrix<T, S, S>& a, const Matrix<T, S, S>& b, const Matrix<T, S, S>& c)
+	{
+		Matrix<T, S, S> m;
+		for (size_t y = 0; y < S; ++y)
+		{
+			T row[S];
+			for (size_t x = 0; x < S; ++x)
+			{
+				row[x] = a(0, y) * b(x, 0);
+				for (size_t i = 1; i < S; ++i)
+					row[x] += a(i, y) * b(x, i);
+			}
+			for (size_t x = 0; x < S; ++x)
+			{
+				T sum = row[0] * c(x, 0);
+				for (size_t i = 1; i < S; ++i)
+					sum += row[i] * c(x, i);
+				m(x, y) = sum;
+			}
+		}
+		out = m;
+	}
+	template <typename T, size_t S>
+	Matrix<T, S, S> Multiply(const Matrix<T, S, S>& a, const Matrix<T, S, S>& b, const Matrix<T, S, S>& c)
+	{
+		Matrix<T, S, S> m;
+		Multiply(m, a, b, c);
+		return m;
+	}
+	// Affine variants assume the last row of every operand is (0, 0, 0, 1)
+	template <typename T>
+	Matrix<T, 4, 4> AffineMultiply(const Matrix<T, 4, 4>& lhs, const Matrix<T, 4, 4>& rhs)
+	{
+		Matrix<T, 4, 4> m;
+		for (size_t y = 0; y < 3; ++y)
+		{
+			for (size_t x = 0; x < 3; ++x)
+				m(x, y) = lhs(0, y) * rhs(x, 0) + lhs(1, y) * rhs(x, 1) + lhs(2, y) * rhs(x, 2);
+			m(3, y) = lhs(0, y) * rhs(3, 0) + lhs(1, y) * rhs(3, 1) + lhs(2, y) * rhs(3, 2) + lhs(3, y);
+		}
+		m(0, 3) = T{0};
+		m(1, 3) = T{0};
+		m(2, 3) = T{0};
+		m(3, 3) = T{1};
+		return m;
+	}
+	template <typename T>
+	void AffineMultiply(Matrix<T, 4, 4>& out, const Matrix<T, 4, 4>& lhs, const Matrix<T, 4, 4>& rhs)
+	{
+		out = AffineMultiply(lhs, rhs);
+	}
+	template <typename T>
+	void AffineMultiply(Matrix<T, 4, 4>& out, const Matrix<T, 4, 4>& a, const Matrix<T, 4, 4>& b, const Matrix<T, 4, 4>& c)
+	{
+		Matrix<T, 4, 4> m;
+		for (size_t y = 0; y < 3; ++y)
+		{
+			T row[4];
+			for (size_t x = 0; x < 4; ++x)
+				row[x] = a(0, y) * b(x, 0) + a(1, y) * b(x, 1) + a(2, y) * b(x, 2);
+			row[3] += a(3, y);
+			for (size_t x = 0; x < 4; ++x)
+				m(x, y) = row[0] * c(x, 0) + row[1] * c(x, 1) + row[2] * c(x, 2) + (x == 3 ? row[3] : T{0});
+		}
+		m(0, 3) = T{0};
+		m(1, 3) = T{0};
+		m(2, 3) = T{0};
+		m(3, 3) = T{1};
+		out = m;
+	}
+
 	template <typename T>
 	Matrix<T, 3, 3> Scaling3x3(const T& x, const T& y, const T& z)
 	{
@@ -536,7 +638,8 @@ namespace democollection::mth
 	template <typename T>
 	Matrix<T, 3, 3> RotationX3x3(const T& a)
 	{
-		T ca = std::cos(a), sa = std::sin(a);
+		T sa, ca;
+		SinCos(a, sa, ca);
 		return Matrix<T, 3, 3>(
 			T{1}, T{0}, T{0},
 			T{0}, ca, -sa,
@@ -545,7 +648,8 @@ namespace democollection::mth
 	template <typename T>
 	Matrix<T, 3, 3> RotationY3x3(const T& a)
 	{
-		T ca = std::cos(a), sa = std::sin(a);
+		T sa, ca;
+		SinCos(a, sa, ca);
 		return Matrix<T, 3, 3>(
 			ca, T{0}, sa,
 			T{0}, T{1}, T{0},
@@ -554,7 +658,8 @@ namespace democollection::mth
 	template <typename T>
 	Matrix<T, 3, 3> RotationZ3x3(const T& a)
 	{
-		T ca = std::cos(a), sa = std::sin(a);
+		T sa, ca;
+		SinCos(a, sa, ca);
 		return Matrix<T, 3, 3>(
 			ca, -sa, T{0},
 			sa, ca, T{0},
@@ -563,7 +668,9 @@ namespace democollection::mth
 	template <typename T>
 	Matrix<T, 3, 3> Rotation3x3(const T& pitch, const T& yaw, const T& roll)
 	{
-		T cp = std::cos(pitch), sp = std::sin(pitch), cy = std::cos(yaw), sy = std::sin(yaw), cr = std::cos(roll), sr = std::sin(roll);
+		Vector<T, 3> s, c;
+		SinCos(Vector<T, 3>(pitch, yaw, roll), s, c);
+		const T sp = s(0), cp = c(0), sy = s(1), cy = c(1), sr = s(2), cr = c(2);
 		return Matrix<T, 3, 3>(
 			sy * sp * sr + cy * cr, sy * sp * cr - cy * sr, sy * cp,
 			cp * sr, cp * cr, -sp,
@@ -592,7 +699,8 @@ namespace democollection::mth
 	template <typename T>
 	Matrix<T, 3, 3> RotationNormal3x3(const Vector<T, 3>& n, const T& a)
 	{
-		T ca = std::cos(a), sa = std::sin(a);
+		T sa, ca;
+		SinCos(a, sa, ca);
 		return Matrix<T, 3, 3>(
 			ca + n(0) * n(0) * (T{1} - ca), n(0) * n(1) * (T{1} - ca) - n(2) * sa, n(0) * n(2) * (T{1} - ca) + n(1) * sa,
 			n(1) * n(0) * (T{1} - ca) + n(2) * sa, ca + n(1) * n(1) * (T{1} - ca), n(1) * n(2) * (T{1} - ca) - n(0) * sa,
@@ -601,7 +709,9 @@ namespace democollection::mth
 	template <typename T>
 	Matrix<T, 3, 3> RotationCamera3x3(const T& pitch, const T& yaw, const T& roll)
 	{
-		T sx = std::sin(-pitch), cx = std::cos(-pitch), sy = std::sin(-yaw), cy = std::cos(-yaw), sz = std::sin(-roll), cz = std::cos(-roll);
+		Vector<T, 3> s, c;
+		SinCos(Vector<T, 3>(-pitch, -yaw, -roll), s, c);
+		const T sx = s(0), cx = c(0), sy = s(1), cy = c(1), sz = s(2), cz = c(2);
 		return Matrix<T, 3, 3>(
 			cy * cz - sx * sy * sz, -cx * sz, sy * cz + sx * cy * sz,
 			cy * sz + sx * sy * cz, cx * cz, sy * sz - sx * cy * cz,
@@ -24,23 +24,31 @@ namespace democollection::mth
 
 		void MoveForward(T d)
 		{
-			position(0) += std::sin(rotation(1)) * d;
-			position(2) += std::cos(rotation(1)) * d;
+			T s, c;
+			SinCos(rotation(1), s, c);
+			position(0) += s * d;
+			position(2) += c * d;
 		}
 		void MoveBackward(T d)
 		{
-			position(0) -= std::sin(rotation(1)) * d;
-			position(2) -= std::cos(rotation(1)) * d;
+			T s, c;
+			SinCos(rotation(1), s, c);
+			position(0) -= s * d;
+			position(2) -= c * d;
 		}
 		void MoveRight(T d)
 		{
-			position(0) += std::cos(rotation(1)) * d;
-			position(2) -= std::sin(rotation(1)) * d;
+			T s, c;
+			SinCos(rotation(1), s, c);
+			position(0) += c * d;
+			position(2) -= s * d;
 		}
 		void MoveLeft(T d)
 		{
-			position(0) -= std::cos(rotation(1)) * d;
-			position(2) += std::sin(rotation(1)) * d;
+			T s, c;
+			SinCos(rotation(1), s, c);
+			position(0) -= c * d;
+			position(2) += s * d;
 		}
 		void MoveUp(T d) { position(1) += d; }
 		void MoveDown(T d) { position(1) -= d; }
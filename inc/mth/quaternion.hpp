@@ -0,0 +1,134 @@
+#pragma once
+
+#include "linalg.hpp"
+
+namespace democollection::mth
+{
+	// Rotation quaternion, w is the real part
+	template <typename T>
+	class Quaternion
+	{
+	public:
+		T x;
+		T y;
+		T z;
+		T w;
+
+	public:
+		Quaternion() : x{0}, y{0}, z{0}, w{1} {}
+		Quaternion(const T& x, const T& y, const T& z, const T& w) : x{x}, y{y}, z{z}, w{w} {}
+
+		Quaternion<T> operator*(const Quaternion<T>& q) const
+		{
+			return Quaternion<T>(
+				w * q.x + x * q.w + y * q.z - z * q.y,
+				w * q.y - x * q.z + y * q.w + z * q.x,
+				w * q.z + x * q.y - y * q.x + z * q.w,
+				w * q.w - x * q.x - y * q.y - z * q.z);
+		}
+		Quaternion<T>& operator*=(const Quaternion<T>& q) { return *this = *this * q; }
+		Quaternion<T> operator*(const T& s) const { return Quaternion<T>(x * s, y * s, z * s, w * s); }
+		Quaternion<T> operator+(const Quaternion<T>& q) const { return Quaternion<T>(x + q.x, y + q.y, z + q.z, w + q.w); }
+		Quaternion<T> operator-() const { return Quaternion<T>(-x, -y, -z, -w); }
+	};
+
+	template <typename T>
+	T Dot(const Quaternion<T>& lhs, const Quaternion<T>& rhs)
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+	}
+	template <typename T>
+	Quaternion<T> Normalized(const Quaternion<T>& q)
+	{
+		return q * (T{1} / std::sqrt(Dot(q, q)));
+	}
+	// Inverse of a unit quaternion
+	template <typename T>
+	Quaternion<T> Conjugate(const Quaternion<T>& q)
+	{
+		return Quaternion<T>(-q.x, -q.y, -q.z, q.w);
+	}
+	template <typename T>
+	Quaternion<T> QuaternionAxisAngle(const Vector<T, 3>& axis, const T& a)
+	{
+		T s, c;
+		SinCos(a * T(0.5), s, c);
+		const Vector<T, 3> n = Normalized(axis) * s;
+		return Quaternion<T>(n(0), n(1), n(2), c);
+	}
+	// Normalized linear interpolation along the shorter arc
+	template <typename T>
+	Quaternion<T> Nlerp(const Quaternion<T>& from, const Quaternion<T>& to, const T& t)
+	{
+		const Quaternion<T> end = Dot(from, to) < T{0} ? -to : to;
+		return Normalized(from * (T{1} - t) + end * t);
+	}
+	// Spherical linear interpolation along the shorter arc
+	template <typename T>
+	Quaternion<T> Slerp(const Quaternion<T>& from, const Quaternion<T>& to, const T& t)
+	{
+		T cosa = Dot(from, to);
+		const Quaternion<T> end = cosa < T{0} ? -to : to;
+		cosa = std::abs(cosa);
+		if (cosa > T(0.9995))
+			return Nlerp(from, end, t);
+		const T a = std::acos(cosa);
+		const T oneOverSin = T{1} / std::sin(a);
+		return from * (std::sin((T{1} - t) * a) * oneOverSin) + end * (std::sin(t * a) * oneOverSin);
+	}
+	template <typename T>
+	Vector<T, 3> Rotate(const Quaternion<T>& q, const Vector<T, 3>& v)
+	{
+		// v + 2w(u x v) + 2u x (u x v), u = (x, y, z)
+		const T tx = T{2} * (q.y * v(2) - q.z * v(1));
+		const T ty = T{2} * (q.z * v(0) - q.x * v(2));
+		const T tz = T{2} * (q.x * v(1) - q.y * v(0));
+		return Vector<T, 3>(
+			v(0) + q.w * tx + q.y * tz - q.z * ty,
+			v(1) + q.w * ty + q.z * tx - q.x * tz,
+			v(2) + q.w * tz + q.x * ty - q.y * tx);
+	}
+	template <typename T>
+	Matrix<T, 3, 3> Rotation3x3(const Quaternion<T>& q)
+	{
+		const T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		const T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		const T wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+		return Matrix<T, 3, 3>(
+			T{1} - T{2} * (yy + zz), T{2} * (xy - wz), T{2} * (xz + wy),
+			T{2} * (xy + wz), T{1} - T{2} * (xx + zz), T{2} * (yz - wx),
+			T{2} * (xz - wy), T{2} * (yz + wx), T{1} - T{2} * (xx + yy));
+	}
+	// Rotation part of 'm', which must not contain scaling
+	template <typename T>
+	Quaternion<T> ToQuaternion(const Matrix<T, 3, 3>& m)
+	{
+		const T trace = m(0, 0) + m(1, 1) + m(2, 2);
+		if (trace > T{0})
+		{
+			const T s = T(0.5) / std::sqrt(trace + T{1});
+			return Quaternion<T>((m(1, 2) - m(2, 1)) * s, (m(2, 0) - m(0, 2)) * s, (m(0, 1) - m(1, 0)) * s, T(0.25) / s);
+		}
+		if (m(0, 0) > m(1, 1) && m(0, 0) > m(2, 2))
+		{
+			const T s = T{2} * std::sqrt(T{1} + m(0, 0) - m(1, 1) - m(2, 2));
+			return Quaternion<T>(T(0.25) * s, (m(1, 0) + m(0, 1)) / s, (m(2, 0) + m(0, 2)) / s, (m(1, 2) - m(2, 1)) / s);
+		}
+		if (m(1, 1) > m(2, 2))
+		{
+			const T s = T{2} * std::sqrt(T{1} + m(1, 1) - m(0, 0) - m(2, 2));
+			return Quaternion<T>((m(1, 0) + m(0, 1)) / s, T(0.25) * s, (m(2, 1) + m(1, 2)) / s, (m(2, 0) - m(0, 2)) / s);
+		}
+		const T s = T{2} * std::sqrt(T{1} + m(2, 2) - m(0, 0) - m(1, 1));
+		return Quaternion<T>((m(2, 0) + m(0, 2)) / s, (m(2, 1) + m(1, 2)) / s, T(0.25) * s, (m(0, 1) - m(1, 0)) / s);
+	}
+
+	template <typename T>
+	std::ostream& operator<<(std::ostream& os, const Quaternion<T>& q)
+	{
+		return os << '(' << q.x << ' ' << q.y << ' ' << q.z << ' ' << q.w << ')' << std::endl;
+	}
+
+	using Quaternionf = Quaternion<float>;
+	using Quaterniond = Quaternion<double>;
+}
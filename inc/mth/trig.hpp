@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace democollection::mth
+{
+	template <typename T, size_t S> class Vector;
+
+	// Precision of SinCos. The bounds are the maximum absolute error for
+	// |a| <= 1000 and are checked by 'make bench-mth'.
+	//  Exact: std::sin and std::cos
+	//  Float: 1.5e-7, about one ulp of a float
+	//  Low:   3e-5, enough for procedural geometry and other visual-only uses
+	// The polynomial variants are branch free, so loops over them vectorize.
+	// The range reduction is done in T, so they lose precision as |a| grows:
+	// the Float error is around 1e-6 at |a| = 1e5. Past that the results are
+	// no longer accurate but stay within [-1, 1], and NaN or infinite angles
+	// give NaN like std::sin.
+	enum class Precision
+	{
+		Exact,
+		Float,
+		Low
+	};
+
+	// Float precision is as good as std::sin for floats, doubles keep the exact version
+	template <typename T> inline constexpr Precision DefaultPrecision = Precision::Exact;
+	template <> inline constexpr Precision DefaultPrecision<float> = Precision::Float;
+
+	// Rounds to the nearest integer without leaving T or calling into libm, so it
+	// stays branch free on every instruction set. Values this large are integers already.
+	template <typename T>
+	inline T RoundToIntegral(const T& x)
+	{
+		constexpr T SHIFT = T(1.5) * static_cast<T>(1ull << (std::numeric_limits<T>::digits - 1));
+		constexpr T LIMIT = static_cast<T>(1ull << (std::numeric_limits<T>::digits - 2));
+		return std::abs(x) < LIMIT ? (x + SHIFT) - SHIFT : x;
+	}
+
+	template <Precision P, typename T>
+	void SinCos(const T& a, T& s, T& c)
+	{
+		if constexpr (P == Precision::Exact)
+		{
+			s = std::sin(a);
+			c = std::cos(a);
+		}
+		else
+		{
+			// a = q * pi/2 + r, r in [-pi/4, pi/4], with pi/2 split in three parts so q * part is exact.
+			// q stays in T, converting it to int would overflow for large angles.
+			const T fq = RoundToIntegral(a * T(0.636619772367581343));
+			const T reduced = ((a - fq * T(1.5703125)) - fq * T(4.837512969970703125e-4)) - fq * T(7.54978995489188216e-8);
+			// only the clamp matters once the reduction loses precision, it keeps NaN
+			const T r = std::min(std::max(reduced, T(-0.785398163397448310)), T(0.785398163397448310));
+			const T r2 = r * r;
+			// only q mod 4 matters, it fits an int; the max turns NaN into a number
+			const int q = static_cast<int>(std::max(T(-2), fq - T(4) * RoundToIntegral(fq * T(0.25)))) & 3;
+
+			T sr, cr;
+			if constexpr (P == Precision::Float)
+			{
+				sr = r + r * r2 * (T(-1.6666654611e-1) + r2 * (T(8.3321608736e-3) + r2 * T(-1.9515295891e-4)));
+				cr = T{1} - T(0.5) * r2 + r2 * r2 * (T(4.166664568298827e-2) + r2 * (T(-1.388731625493765e-3) + r2 * T(2.443315711809948e-5)));
+			}
+			else
+			{
+				sr = r + r * r2 * (T(-1.6663375595e-1) + r2 * T(8.1652911002e-3));
+				cr = T{1} + r2 * (T(-4.9981562796e-1) + r2 * T(4.0587600996e-2));
+			}
+
+			// odd quadrants swap sine and cosine, the signs follow the quadrant
+			const T sv = (q & 1) ? cr : sr;
+			const T cv = (q & 1) ? sr : cr;
+			s = (q & 2) ? -sv : sv;
+			c = ((q + 1) & 2) ? -cv : cv;
+		}
+	}
+	template <typename T>
+	void SinCos(const T& a, T& s, T& c)
+	{
+		SinCos<DefaultPrecision<T>>(a, s, c);
+	}
+	template <Precision P, typename T, size_t S>
+	void SinCos(const Vector<T, S>& a, Vector<T, S>& s, Vector<T, S>& c)
+	{
+		for (size_t i = 0; i < S; ++i)
+			SinCos<P>(a(i), s(i), c(i));
+	}
+	template <typename T, size_t S>
+	void SinCos(const Vector<T, S>& a, Vector<T, S>& s, Vector<T, S>& c)
+	{
+		SinCos<DefaultPrecision<T>>(a, s, c);
+	}
+	// Batched version for tables: sines[i], cosines[i] = sin, cos of angles[i]
+	template <Precision P, typename T>
+	void SinCos(const T* angles, T* sines, T* cosines, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			SinCos<P>(angles[i], sines[i], cosines[i]);
+	}
+	template <typename T>
+	void SinCos(const T* angles, T* sines, T* cosines, size_t count)
+	{
+		SinCos<DefaultPrecision<T>>(angles, sines, cosines, count);
+	}
+}
@@ -196,6 +196,7 @@ namespace democollection
 		std::vector<std::string> m_textureNames;
 		std::vector<Material> m_materials;
 		std::vector<Bone> m_bones;
+		std::vector<int> m_boneRemap; // file bone index -> skeleton bone index
 		Status m_status;
 
 	private:
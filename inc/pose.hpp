@@ -0,0 +1,56 @@
+#pragma once
+
+#include "skeleton.hpp"
+
+namespace democollection
+{
+	// Local transforms of all bones of a skeleton as separate component arrays,
+	// so blending runs as plain loops over floats that the compiler vectorizes.
+	// Like the skeleton's local transforms, the pose is relative to the rest pose.
+	class Pose
+	{
+		std::vector<float> m_rotations[4];		// quaternion x, y, z, w
+		std::vector<float> m_translations[3];
+
+	public:
+		explicit Pose(size_t boneCount = 0);
+
+		void Resize(size_t boneCount);
+		// Rest pose: identity rotations and zero translations
+		void SetIdentity();
+		// Writes the pose into the local transforms of 'skeleton', which must have as many bones
+		void Apply(Skeleton& skeleton) const;
+
+		inline size_t Size() const { return m_translations[0].size(); }
+		inline mth::Quaternionf Rotation(size_t bone) const
+		{
+			return mth::Quaternionf(m_rotations[0][bone], m_rotations[1][bone], m_rotations[2][bone], m_rotations[3][bone]);
+		}
+		inline void SetRotation(size_t bone, const mth::Quaternionf& q)
+		{
+			m_rotations[0][bone] = q.x;
+			m_rotations[1][bone] = q.y;
+			m_rotations[2][bone] = q.z;
+			m_rotations[3][bone] = q.w;
+		}
+		inline mth::float3 Translation(size_t bone) const
+		{
+			return mth::float3(m_translations[0][bone], m_translations[1][bone], m_translations[2][bone]);
+		}
+		inline void SetTranslation(size_t bone, const mth::float3& t)
+		{
+			m_translations[0][bone] = t(0);
+			m_translations[1][bone] = t(1);
+			m_translations[2][bone] = t(2);
+		}
+		inline float* Rotations(size_t component) { return m_rotations[component].data(); }
+		inline const float* Rotations(size_t component) const { return m_rotations[component].data(); }
+		inline float* Translations(size_t component) { return m_translations[component].data(); }
+		inline const float* Translations(size_t component) const { return m_translations[component].data(); }
+	};
+
+	// out = nlerp(a, b, weight * mask[i]) for every bone i; 'out' may be 'a' or 'b'
+	void BlendPoses(Pose& out, const Pose& a, const Pose& b, float weight, const float* mask);
+	// out = base followed by 'additive' scaled by weight * mask[i]; 'out' may be 'base'
+	void AddPoses(Pose& out, const Pose& base, const Pose& additive, float weight, const float* mask);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "mth/affine.hpp"
+#include "mth/quaternion.hpp"
+
+#include <string>
+#include <vector>
+
+namespace democollection
+{
+	// Bone hierarchy stored as parallel arrays. Parents always come before their
+	// children, so the whole hierarchy is evaluated in one linear pass.
+	class Skeleton
+	{
+		std::vector<std::string> m_names;
+		std::vector<int> m_parents;							// smaller than the bone's own index, -1 for roots
+		std::vector<mth::float3> m_bindPositions;			// rest position in model space
+		std::vector<mth::float3> m_bindOffsets;				// rest position relative to the parent
+		std::vector<mth::Affine3x4f> m_localTransforms;		// pose, relative to the rest position of the bone
+		std::vector<mth::Affine3x4f> m_globalTransforms;	// model space
+
+	public:
+		// Order of the bones in which every parent precedes its children. Already
+		// ordered bones keep their order, out of range parents and cycles become roots.
+		static std::vector<int> ParentFirstOrder(const std::vector<int>& parents);
+
+		// Appends a bone and returns its index; 'parent' has to be an existing bone or -1
+		int AddBone(const std::string& name, int parent, const mth::float3& bindPosition);
+		// Index of the bone with the given name or -1
+		int FindBone(const std::string& name) const;
+		void Clear();
+		void ResetPose();
+
+		// global = parent global * rest offset * local, 'world' is the parent of the roots;
+		// bones before 'firstBone' are expected to be up to date already
+		void UpdateGlobalTransforms(const mth::Affine3x4f& world = mth::Affine3x4f(), size_t firstBone = 0);
+		// Same for a single bone whose parent is up to date
+		void UpdateGlobalTransform(size_t bone, const mth::Affine3x4f& world = mth::Affine3x4f());
+		// out[i] = global * inverse bind transform; 'out' is only written, it can be mapped memory
+		void WriteSkinningMatrices(mth::Affine3x4f* out) const;
+		// Same transforms as unit dual quaternions, out[2 * i] is the rotation and out[2 * i + 1]
+		// the dual part, both (x, y, z, w); the pose must not contain scaling
+		void WriteSkinningDualQuaternions(mth::float4* out) const;
+
+		inline size_t Size() const { return m_parents.size(); }
+		inline bool Empty() const { return m_parents.empty(); }
+		inline const std::string& Name(size_t bone) const { return m_names[bone]; }
+		inline int Parent(size_t bone) const { return m_parents[bone]; }
+		inline const mth::float3& BindPosition(size_t bone) const { return m_bindPositions[bone]; }
+		inline mth::Affine3x4f& LocalTransform(size_t bone) { return m_localTransforms[bone]; }
+		inline const mth::Affine3x4f& LocalTransform(size_t bone) const { return m_localTransforms[bone]; }
+		inline const mth::Affine3x4f& GlobalTransform(size_t bone) const { return m_globalTransforms[bone]; }
+	};
+}
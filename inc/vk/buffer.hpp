@@ -1,6 +1,6 @@
 #pragma once
 
-#include "vk/singletimecommandbuffer.hpp"
+#include "vk/deletionqueue.hpp"
 
 namespace democollection::vk
 {
@@ -15,22 +15,25 @@ namespace democollection::vk
 	protected:
 		const Vulkan& m_vulkan;
 		VkBuffer m_buffers[C];
-		VkDeviceMemory m_memory;
+		Allocation m_memory;
 
 	protected:
 		BufferResources(const Vulkan& vulkan)
 			: m_vulkan{vulkan}
 			, m_buffers{}
-			, m_memory{VK_NULL_HANDLE}
+			, m_memory{}
 		{
 			for (VkBuffer& b : m_buffers)
 				b = VK_NULL_HANDLE;
 		}
 		~BufferResources()
 		{
-			for (VkBuffer& b : m_buffers)
-				SAFE_DESTROY(vkDestroyBuffer, b, m_vulkan.Device(), b, m_vulkan.Allocator());
-			SAFE_DESTROY(vkFreeMemory, m_memory, m_vulkan.Device(), m_memory, m_vulkan.Allocator());
+			// frames in flight may still read the buffers
+			m_vulkan.Deletions().Push([&vulkan = m_vulkan, buffers = std::to_array(m_buffers), memory = m_memory]() mutable {
+				for (VkBuffer& b : buffers)
+					SAFE_DESTROY(vkDestroyBuffer, b, vulkan.Device(), b, vulkan.Allocator());
+				vulkan.Memory().Free(memory);
+			});
 		}
 	};
 
@@ -43,36 +46,56 @@ namespace democollection::vk
 			Staging,
 			Vertex,
 			Index,
-			Uniform
+			Uniform,
+			Storage,
+			DeviceStorage	// written once through the transfer batch
 		};
 
 	protected:
 		VkDeviceSize m_size;
+		VkDeviceSize m_stride; // distance between the copies in memory, respects the alignment of the buffers
 
 	protected:
 		BufferBase(const Vulkan& vulkan, Type type, VkDeviceSize size, const void* initialData)
 			: BufferResources<C>(vulkan)
 			, m_size{size}
+			, m_stride{}
 		{
 			VkBufferUsageFlags usage;
 			VkMemoryPropertyFlags properties;
+			MemoryCategory category;
 
 			switch (type) {
 				case Type::Staging:
 					usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 					properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+					category = MemoryCategory::Staging;
 					break;
 				case Type::Vertex:
-					usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+					// the skinning shader reads the mesh vertices and writes the skinned ones as storage buffers
+					usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
 					properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+					category = MemoryCategory::Mesh;
 					break;
 				case Type::Index:
 					usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
 					properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+					category = MemoryCategory::Mesh;
 					break;
 				case Type::Uniform:
 					usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 					properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+					category = MemoryCategory::Uniform;
+					break;
+				case Type::Storage:
+					usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+					properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+					category = MemoryCategory::Storage;
+					break;
+				case Type::DeviceStorage:
+					usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+					properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+					category = MemoryCategory::Storage;
 					break;
 				default:
 					Throw("Unsupported buffer type");
@@ -88,41 +111,35 @@ namespace democollection::vk
 
 			VkMemoryRequirements memRequirements{};
 			vkGetBufferMemoryRequirements(BufferResources<C>::m_vulkan.Device(), BufferResources<C>::m_buffers[0], &memRequirements);
-
-			VkMemoryAllocateInfo allocInfo{};
-			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			allocInfo.allocationSize = memRequirements.size * C;
-			allocInfo.memoryTypeIndex = BufferResources<C>::m_vulkan.FindMemoryType(memRequirements.memoryTypeBits, properties);
-			ThrowIfFailed(vkAllocateMemory(BufferResources<C>::m_vulkan.Device(), &allocInfo, BufferResources<C>::m_vulkan.Allocator(), &(BufferResources<C>::m_memory)));
+			m_stride = (memRequirements.size + memRequirements.alignment - 1) / memRequirements.alignment * memRequirements.alignment;
+
+			// all copies share one range of the allocator
+			memRequirements.size = m_stride * C;
+			MemoryAllocator& allocator = BufferResources<C>::m_vulkan.Memory();
+			Allocation& memory = BufferResources<C>::m_memory;
+			// the host rewrites these every frame, if it can write device local memory the GPU reads
+			// them from there; once that heap is full they go to plain host memory
+			const bool dynamic = type == Type::Uniform || type == Type::Storage;
+			if (dynamic && allocator.HasHostVisibleDeviceLocal(memRequirements.memoryTypeBits))
+				memory = allocator.TryAllocate(memRequirements, properties | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryAllocator::Kind::Linear, category);
+			if (!memory)
+				memory = allocator.Allocate(memRequirements, properties, MemoryAllocator::Kind::Linear, category);
 
 			for (uint32_t i = 0; i < C; ++i)
-				ThrowIfFailed(vkBindBufferMemory(BufferResources<C>::m_vulkan.Device(), BufferResources<C>::m_buffers[i], BufferResources<C>::m_memory, i * m_size));
+				ThrowIfFailed(vkBindBufferMemory(BufferResources<C>::m_vulkan.Device(), BufferResources<C>::m_buffers[i], memory.memory, memory.offset + i * m_stride));
 
 			if (initialData)
 			{
-				uint8_t* data;
-				ThrowIfFailed(vkMapMemory(BufferResources<C>::m_vulkan.Device(), BufferResources<C>::m_memory, 0, m_size * C, 0, reinterpret_cast<void**>(&data)));
+				ThrowIfFalse(memory.mapped, "Initial data needs host visible memory");
+				uint8_t* data = static_cast<uint8_t*>(memory.mapped);
 				for (uint32_t i = 0; i < C; ++i)
-					memcpy(data + (i * m_size), initialData, m_size);
-				vkUnmapMemory(BufferResources<C>::m_vulkan.Device(), BufferResources<C>::m_memory);
+					memcpy(data + (i * m_stride), initialData, m_size);
 			}
 		}
 
 	public:
-		void CopyDataFrom(const BufferBase<C>& src) const
-		{
-			SingleTimeCommandBuffer cmdBuffer(BufferResources<C>::m_vulkan);
-
-			VkBufferCopy copyRegion{};
-			copyRegion.srcOffset = 0;
-			copyRegion.dstOffset = 0;
-			copyRegion.size = m_size;
-			for (uint32_t i = 0; i < C; ++i)
-				vkCmdCopyBuffer(cmdBuffer.CommandBuffer(), src.m_buffers[i], BufferResources<C>::m_buffers[i], 1, &copyRegion);
-
-			cmdBuffer.Submit();
-		}
 		inline VkDeviceSize Size() const { return m_size; }
+		inline void* Mapped() const { return BufferResources<C>::m_memory.mapped; }
 	};
 
 	class Buffer : public BufferBase<1>
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "vk/vulkan.hpp"
+
+#include <deque>
+
+namespace democollection::vk
+{
+	// Destruction of objects the GPU may still be using. Resources push the
+	// release of their handles instead of destroying them, tagged with the frame
+	// being recorded, and it runs once every frame that could have used them has
+	// completed. Unloading then never waits for the device to go idle.
+	class DeletionQueue
+	{
+		DeletionQueue(const DeletionQueue&) = delete;
+		DeletionQueue(DeletionQueue&&) = delete;
+		void operator=(const DeletionQueue&) = delete;
+		void operator=(DeletionQueue&&) = delete;
+
+		struct Entry
+		{
+			uint64_t frame;
+			std::function<void()> release;
+		};
+
+	private:
+		std::deque<Entry> m_entries;	// oldest first
+		uint64_t m_frame;
+
+	public:
+		DeletionQueue();
+
+		void Push(std::function<void()> release);
+		// Starts a new frame, called after waiting for the fence of the frame MAX_FRAMES_IN_FLIGHT
+		// before it; releases what the completed frames were the last to use
+		void NextFrame();
+		// Releases everything, the device has to be idle
+		void ReleaseAll();
+
+		inline size_t Size() const { return m_entries.size(); }
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "uniformbuffer.hpp"
+#include "storagebuffer.hpp"
 #include "texture.hpp"
 
 namespace democollection::vk
@@ -39,10 +40,21 @@ namespace democollection::vk
 		DescriptorSet(const Vulkan& vulkan,
 				VkDescriptorPool descriptorPool,
 				const UniformBuffer& sceneBufferVs,
-				const UniformBuffer& modelBufferVs,
 				const UniformBuffer& sceneBufferFs,
-				const UniformBuffer& modelBufferFs,
+				const Buffer& materials,
 				const Texture& texture);
 		void Bind() const;
 	};
+
+	// Inputs and output of the skinning compute shader, the vertex buffers of the geometry arena
+	class SkinningDescriptorSet : private DescriptorSetResources
+	{
+	public:
+		SkinningDescriptorSet(const Vulkan& vulkan,
+				VkDescriptorPool descriptorPool,
+				const StorageBuffer& palettes,
+				const Buffer& sourceVertices,
+				const PerFrameBuffer& skinnedVertices);
+		void Bind() const;
+	};
 }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "buffer.hpp"
+#include "tlsf.hpp"
+#include "types.hpp"
+
+namespace democollection::vk
+{
+	// Vertices and indices of all meshes in one vertex and one index buffer, plus the
+	// skinned vertices of every model drawing them in a third. A mesh is uploaded once
+	// and its instances only reserve skinned vertices, so a crowd costs one copy of
+	// the source geometry. The buffers are bound once, models draw with vertexOffset
+	// at their skinned vertices and firstIndex at the mesh's indices.
+	class GeometryArena
+	{
+		Buffer m_vertices;
+		Buffer m_indices;
+		PerFrameBuffer m_skinnedVertices;
+		// in vertices and indices
+		Tlsf m_vertexRanges;
+		Tlsf m_indexRanges;
+		Tlsf m_skinnedVertexRanges;
+
+	public:
+		GeometryArena(const Vulkan& vulkan, uint32_t vertexCapacity, uint32_t indexCapacity, uint32_t skinnedVertexCapacity);
+
+		// Reserves 'vertexCount' vertices and 'indexCount' indices, returns their handles and first elements
+		void Allocate(uint32_t vertexCount, uint32_t indexCount, Tlsf::Handle ranges[2], uint32_t& firstVertex, uint32_t& firstIndex);
+		void Free(const Tlsf::Handle ranges[2]);
+		// Reserves the output of skinning one mesh instance
+		Tlsf::Handle AllocateSkinned(uint32_t vertexCount, uint32_t& firstVertex);
+		void FreeSkinned(Tlsf::Handle range);
+		// Binds the skinned vertices and the indices of all meshes
+		void Bind(VkCommandBuffer commandBuffer, uint32_t frame) const;
+
+		inline const Buffer& Vertices() const { return m_vertices; }
+		inline const Buffer& Indices() const { return m_indices; }
+		inline const PerFrameBuffer& SkinnedVertices() const { return m_skinnedVertices; }
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "buffer.hpp"
+#include "types.hpp"
+#include "modeltypes.hpp"
+
+namespace democollection::vk
+{
+	// Material parameters of all models in one device local storage buffer. They
+	// never change, so they are uploaded once when added; draws select theirs with
+	// the material index push constant.
+	class MaterialArena
+	{
+		const Vulkan& m_vulkan;
+		vk::Buffer m_buffer;
+		uint32_t m_capacity;
+		uint32_t m_used;
+
+	public:
+		MaterialArena(const Vulkan& vulkan, uint32_t capacity);
+
+		// Uploads the parameters of 'materials', returns the index of the first one
+		uint32_t Add(const std::vector<MaterialData>& materials);
+
+		inline const vk::Buffer& Buffer() const { return m_buffer; }
+	};
+}
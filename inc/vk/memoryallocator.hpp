@@ -0,0 +1,151 @@
+#pragma once
+
+#include "tlsf.hpp"
+
+namespace democollection::vk
+{
+	// What an allocation is used for, memory usage is accounted per category
+	enum class MemoryCategory : uint32_t
+	{
+		Mesh,
+		Texture,
+		Uniform,
+		Storage,
+		Staging,
+		Attachment,	// render targets of the swapchain
+		Count
+	};
+
+	// Range of device memory handed out by the MemoryAllocator
+	struct Allocation
+	{
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr;		// start of the range if the memory is host visible
+		uint32_t pool = 0;
+		uint32_t block = 0;
+		Tlsf::Handle range = Tlsf::NONE;	// NONE for dedicated allocations
+		MemoryCategory category = MemoryCategory::Mesh;
+
+		inline explicit operator bool() const { return memory != VK_NULL_HANDLE; }
+	};
+
+	// Hands out ranges of large per memory type blocks instead of allocating
+	// device memory for every resource, so the number of driver allocations
+	// stays far below maxMemoryAllocationCount. Requests larger than half a
+	// block get their own allocation. Optimal tiling images are kept in blocks
+	// of their own whenever bufferImageGranularity could make them share a page
+	// with linear resources. Host visible blocks are mapped once for their
+	// whole lifetime. Not thread safe, resources are created on one thread.
+	//
+	// Every allocation is accounted to its category with live totals and high
+	// water marks. Heap budgets come from VK_EXT_memory_budget when the device
+	// has it, they then include what other processes use.
+	class MemoryAllocator
+	{
+		MemoryAllocator(const MemoryAllocator&) = delete;
+		MemoryAllocator(MemoryAllocator&&) = delete;
+		void operator=(const MemoryAllocator&) = delete;
+		void operator=(MemoryAllocator&&) = delete;
+
+	public:
+		enum class Kind
+		{
+			Linear,			// buffers and linear tiling images
+			OptimalImage
+		};
+
+		struct Stats
+		{
+			uint32_t blockCount;
+			uint32_t dedicatedCount;
+			uint32_t allocationCount;
+			VkDeviceSize reservedBytes;	// blocks and dedicated allocations
+			VkDeviceSize usedBytes;
+			VkDeviceSize peakReservedBytes;
+			VkDeviceSize peakUsedBytes;
+		};
+
+		struct CategoryStats
+		{
+			uint32_t allocationCount;
+			VkDeviceSize usedBytes;
+			VkDeviceSize peakUsedBytes;
+		};
+
+		struct HeapBudget
+		{
+			VkDeviceSize size;
+			VkDeviceSize budget;		// what the process can use before performance suffers, the heap size without the extension
+			VkDeviceSize usage;			// by the whole process with the extension, by this allocator without
+			VkDeviceSize reservedBytes;	// by this allocator
+			bool deviceLocal;
+		};
+
+		static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull << 20;
+		// Without resizable BAR only a 256 MiB window of device memory is host visible
+		static constexpr VkDeviceSize BAR_WINDOW_SIZE = 256ull << 20;
+
+	private:
+		struct Block
+		{
+			VkDeviceMemory memory;
+			void* mapped;
+			Tlsf ranges;
+		};
+
+		struct Pool
+		{
+			uint32_t memoryType;
+			VkDeviceSize blockSize;
+			std::vector<std::unique_ptr<Block>> blocks;	// null where a block has been released
+		};
+
+	private:
+		VkDevice m_device;
+		VkPhysicalDevice m_physicalDevice;
+		const VkAllocationCallbacks* m_callbacks;
+		VkPhysicalDeviceMemoryProperties m_properties;
+		bool m_memoryBudget;
+		bool m_separateImages;
+		std::vector<Pool> m_pools;		// Kind::Linear and Kind::OptimalImage of every memory type
+		Stats m_dedicated;
+		CategoryStats m_categories[static_cast<uint32_t>(MemoryCategory::Count)];
+		std::vector<VkDeviceSize> m_heapReserved;
+		VkDeviceSize m_reservedBytes;
+		VkDeviceSize m_usedBytes;
+		VkDeviceSize m_peakReservedBytes;
+		VkDeviceSize m_peakUsedBytes;
+
+	private:
+		VkDeviceMemory AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, void** mapped);
+		void FreeDeviceMemory(uint32_t memoryType, VkDeviceMemory memory, VkDeviceSize size);
+		void AddUsed(MemoryCategory category, VkDeviceSize size);
+
+	public:
+		// 'memoryBudget' if VK_EXT_memory_budget is enabled on the device
+		MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* callbacks, bool memoryBudget);
+		~MemoryAllocator();
+
+		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+		// True if the host can write device local memory directly, with resizable BAR or on
+		// integrated GPUs. The small BAR window does not count, it runs out too easily.
+		bool HasHostVisibleDeviceLocal(uint32_t typeFilter) const;
+		// Like Allocate, but returns an empty allocation when the heap is out of memory
+		Allocation TryAllocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, Kind kind, MemoryCategory category);
+		Allocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, Kind kind, MemoryCategory category);
+		// Allocates and binds memory for an optimal tiling image
+		Allocation AllocateImage(VkImage image, VkMemoryPropertyFlags properties, MemoryCategory category);
+		// Releases the range and resets 'allocation'; empty blocks are released as well
+		void Free(Allocation& allocation);
+
+		Stats GetStats() const;
+		inline const CategoryStats& GetStats(MemoryCategory category) const { return m_categories[static_cast<uint32_t>(category)]; }
+		// One per memory heap, queried from the driver on every call
+		std::vector<HeapBudget> GetHeapBudgets() const;
+		inline bool HasMemoryBudget() const { return m_memoryBudget; }
+
+		static const char* CategoryName(MemoryCategory category);
+	};
+}
@@ -1,21 +1,59 @@
 #pragma once
 
-#include "buffer.hpp"
-#include "types.hpp"
+#include "geometryarena.hpp"
 
 namespace democollection::vk
 {
+	// A range of vertices and indices in the geometry arena
 	class Mesh
 	{
+		Mesh(const Mesh&) = delete;
+		Mesh(Mesh&&) = delete;
+		void operator=(const Mesh&) = delete;
+		void operator=(Mesh&&) = delete;
+
+		const Vulkan& m_vulkan;
+		GeometryArena& m_arena;
+		Tlsf::Handle m_ranges[2];
+		uint32_t m_firstVertex;
+		uint32_t m_vertexCount;
+		uint32_t m_firstIndex;
+		uint32_t m_indexCount;
+
+	public:
+		Mesh(const Vulkan& vulkan, GeometryArena& arena, const Vertex vertices[], uint32_t vertexCount, const uint32_t indices[], uint32_t indexCount);
+		~Mesh();
+
+		inline uint32_t FirstVertex() const { return m_firstVertex; }
+		inline uint32_t VertexCount() const { return m_vertexCount; }
+		inline uint32_t FirstIndex() const { return m_firstIndex; }
+		inline uint32_t IndexCount() const { return m_indexCount; }
+	};
+
+	// A model's use of a shared mesh, only the skinned vertices are its own
+	class MeshInstance
+	{
+		MeshInstance(const MeshInstance&) = delete;
+		MeshInstance(MeshInstance&&) = delete;
+		void operator=(const MeshInstance&) = delete;
+		void operator=(MeshInstance&&) = delete;
+
 		const Vulkan& m_vulkan;
-		Buffer m_vertexBuffer;
-		Buffer m_indexBuffer;
+		GeometryArena& m_arena;
+		std::shared_ptr<const Mesh> m_mesh;
+		Tlsf::Handle m_skinnedRange;
+		uint32_t m_firstSkinnedVertex;
 
 	public:
-		Mesh(const Vulkan& vulkan, const Vertex vertices[], uint32_t vertexCount, const uint32_t indices[], uint32_t indexCount);
+		MeshInstance(const Vulkan& vulkan, GeometryArena& arena, std::shared_ptr<const Mesh> mesh);
+		~MeshInstance();
 
-		void Bind() const;
+		// The arena has to be bound, once for all instances
 		void Draw() const;
+		// Draws 'count' indices from 'first', relative to the mesh
 		void Draw(uint32_t first, uint32_t count) const;
+
+		inline const Mesh& GetMesh() const { return *m_mesh; }
+		inline uint32_t FirstSkinnedVertex() const { return m_firstSkinnedVertex; }
 	};
 }
@@ -2,8 +2,14 @@
 
 #include <vk/descriptor.hpp>
 #include "mesh.hpp"
+#include "palettearena.hpp"
+#include "materialarena.hpp"
+#include "posecache.hpp"
 #include "graphics.hpp"
 #include "modelloader.hpp"
+#include "animationblender.hpp"
+
+#include <optional>
 
 namespace democollection::vk
 {
@@ -13,29 +19,69 @@ namespace democollection::vk
 		{
 			uint32_t firstIndex;
 			uint32_t indexCount;
-			std::unique_ptr<UniformBuffer> fsBuffer;
+			uint32_t material;	// index in the material arena
 			std::shared_ptr<Texture> texture;
 			std::unique_ptr<DescriptorSet> descriptorSet;
 		};
 
 	private:
 		Graphics& m_graphics;
-		std::unique_ptr<UniformBuffer> m_vsBuffer;
-		std::unique_ptr<Mesh> m_mesh;
+		const PaletteArena& m_paletteArena;
+		uint32_t m_paletteOffset;
+		uint32_t m_drawnPaletteOffset;	// m_paletteOffset or the range of the model sharing its pose
+		std::optional<PoseCache::Key> m_poseKey;	// when the pose is a single clip the cache can hold
+		uint64_t m_rigKey;
+		std::unique_ptr<MeshInstance> m_mesh;
 		std::unique_ptr<DescriptorPool> m_descriptorPool;
+		std::unique_ptr<SkinningDescriptorSet> m_skinningDescriptorSet;
 		std::vector<ModelPart> m_parts;
-		std::vector<vk::Bone> m_skeleton;
-
-	private:
-		mth::float4x4& BoneTransforms(int index) const;
+		Skeleton m_skeleton;
+		std::unique_ptr<AnimationBlender> m_blender;
+		IkSolver m_ikSolver;
+		mth::Affine3x4f m_world;
+		SkinningMode m_skinningMode;
+		bool m_posed;	// Animate has run at least once, the skeleton is past its bind pose
 
 	public:
 		Model(Graphics& graphics,
 				const UniformBuffer& sceneBufferVs,
 				const UniformBuffer& sceneBufferFs,
+				PaletteArena& paletteArena,
+				GeometryArena& geometryArena,
+				std::shared_ptr<const Mesh> mesh,	// the loader's geometry, shared by all models of it
+				const MaterialArena& materialArena,
+				uint32_t firstMaterial,		// of the loader's materials, added to the arena
 				const ModelLoader& modelLoader);
 
-		void Update();
+		// Plays 'motion' on the base layer from time 0 without blending
+		void SetMotion(std::shared_ptr<const CompressedMotion> motion);
+		inline AnimationBlender& Blender() { return *m_blender; }
+		inline void SetWorldTransform(const mth::Affine3x4f& world) { m_world = world; }
+		// Takes effect with the next WritePalette
+		inline void SetSkinningMode(SkinningMode mode) { m_skinningMode = mode; }
+		inline SkinningMode GetSkinningMode() const { return m_skinningMode; }
+
+		// Looks the pose at 'time' up in 'cache'. If another model already evaluates the
+		// same pose this frame, this one skins with that palette and SharesPose() is true,
+		// neither Animate nor WritePalette are needed then. Otherwise Animate evaluates the
+		// frame the cache rounded to until the next call. A sharer never animates its own
+		// skeleton, if the owner misses the frame budget it draws the owner's last pose.
+		void SharePose(PoseCache& cache, float time);
+		inline bool SharesPose() const { return m_drawnPaletteOffset != m_paletteOffset; }
+		// False until the first Animate, WritePalette would write the bind pose before
+		inline bool HasPose() const { return m_posed; }
+		// Samples the motion at 'time' seconds, looping, and evaluates the skeleton including IK
+		void Animate(float time);
+		// Writes the model space skinning palette of the current pose for the current frame in the format of the skinning mode
+		void WritePalette() const;
+		inline void Update(float time)
+		{
+			Animate(time);
+			WritePalette();
+		}
+		// Records the skinning dispatch, has to come before the render pass
+		void Skin() const;
+		// Draws with the geometry arena bound
 		void Render() const;
 	};
 }
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "storagebuffer.hpp"
+#include "types.hpp"
+
+namespace democollection::vk
+{
+	// Bone palettes of all models in one storage buffer per frame. Every model
+	// reserves its range once and passes the offset to the skinning shader, so
+	// all dispatches share a single binding and skeletons can have any size.
+	class PaletteArena
+	{
+		StorageBuffer m_buffer;
+		uint32_t m_capacity;	// in float4
+		uint32_t m_used;
+
+	public:
+		// float4 per bone, enough for both skinning modes
+		static constexpr uint32_t BONE_SIZE = sizeof(mth::Affine3x4f) / sizeof(mth::float4);
+
+		PaletteArena(const Vulkan& vulkan, uint32_t boneCapacity);
+
+		// Reserves room for 'boneCount' bones, returns the offset of the range in float4
+		uint32_t Allocate(uint32_t boneCount);
+
+		// Palette memory of the current frame at 'offset'
+		inline mth::float4* Data(uint32_t offset) const { return m_buffer.Data<mth::float4>() + offset; }
+		inline const StorageBuffer& Buffer() const { return m_buffer; }
+		inline uint32_t Capacity() const { return m_capacity / BONE_SIZE; }
+		inline uint32_t Used() const { return m_used / BONE_SIZE; }
+	};
+}
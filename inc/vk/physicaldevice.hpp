@@ -10,6 +10,7 @@ namespace democollection::vk
 		VkPhysicalDevice m_device;
 		uint32_t m_graphicsQueueIndex;
 		uint32_t m_presentQueueIndex;
+		uint32_t m_transferQueueIndex;
 		VkSurfaceCapabilitiesKHR m_surfaceCapabilities;
 		VkSurfaceFormatKHR m_surfaceFormat;
 		VkFormat m_depthFormat;
@@ -17,12 +18,14 @@ namespace democollection::vk
 		VkPhysicalDeviceProperties m_properties;
 		VkPhysicalDeviceFeatures m_features;
 		VkSampleCountFlagBits m_msaaSampleCount;
+		bool m_memoryBudget;
 
 	public:
 		static const char* sDeviceExtensions[1];
 
 	private:
-		bool CheckDeviceExtensionSupport() const;
+		bool IsExtensionSupported(const std::vector<VkExtensionProperties>& availableExtensions, const char* extension) const;
+		bool CheckDeviceExtensionSupport();
 		uint32_t ScorePhysicalDeviceQueues(VkSurfaceKHR surface);
 		uint32_t ScoreSurfaceFormat(VkSurfaceKHR surface);
 		uint32_t ScoreDepthFormat();
@@ -39,6 +42,9 @@ namespace democollection::vk
 		inline VkPhysicalDevice Device() const { return m_device; }
 		inline uint32_t GraphicsQueueIndex() const { return m_graphicsQueueIndex; }
 		inline uint32_t PresentQueueIndex() const { return m_presentQueueIndex; }
+		// A transfer only family if the device has one, the graphics family otherwise
+		inline uint32_t TransferQueueIndex() const { return m_transferQueueIndex; }
+		inline bool HasDedicatedTransferQueue() const { return m_transferQueueIndex != m_graphicsQueueIndex; }
 		inline const VkPhysicalDeviceProperties& Properties() const { return m_properties; }
 		inline const VkPhysicalDeviceFeatures& Features() const { return m_features; }
 		inline const VkSurfaceCapabilitiesKHR& SurfaceCapabilities() const { return m_surfaceCapabilities; }
@@ -46,5 +52,7 @@ namespace democollection::vk
 		inline VkFormat DepthFormat() const { return m_depthFormat; }
 		inline VkPresentModeKHR PresentMode() const { return m_presentMode; }
 		inline VkSampleCountFlagBits MsaaSampleCount() const { return m_msaaSampleCount; }
+		// VK_EXT_memory_budget is optional, it needs Vulkan 1.1 for vkGetPhysicalDeviceMemoryProperties2
+		inline bool HasMemoryBudget() const { return m_memoryBudget; }
 	};
 }
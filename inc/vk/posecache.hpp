@@ -0,0 +1,61 @@
+#pragma once
+
+#include "vulkan.hpp"
+#include "iksolver.hpp"
+#include "compressedmotion.hpp"
+
+#include <unordered_map>
+
+namespace democollection::vk
+{
+	// Palettes evaluated during the current frame, keyed by everything a pose
+	// that plays a single clip depends on. The first model asking for a key
+	// evaluates it into its own palette range, later ones with the same key
+	// skip animating and skin from that range instead. If the owner misses the
+	// frame budget, the range keeps its previous pose for all of them. Frames
+	// can be rounded to a step so instances at nearby times share as well.
+	class PoseCache
+	{
+	public:
+		struct Key
+		{
+			const CompressedMotion* motion;
+			uint64_t rig;			// RigKey of the skeleton
+			float frame;			// already quantized
+			SkinningMode mode;		// the palette format
+
+			inline bool operator==(const Key& other) const
+			{
+				return motion == other.motion && rig == other.rig && frame == other.frame && mode == other.mode;
+			}
+		};
+
+	private:
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const;
+		};
+
+	private:
+		std::unordered_map<Key, uint32_t, KeyHash> m_palettes;
+		float m_frameStep;
+		uint32_t m_hits;
+
+	public:
+		// 'frameStep' in motion frames, 0 only shares exactly equal frames
+		explicit PoseCache(float frameStep = 0.0f);
+
+		// Hash of the bones and IK chains, equal for every instance of a model
+		static uint64_t RigKey(const Skeleton& skeleton, const std::vector<IkChain>& ikChains);
+
+		float Quantize(float frame) const;
+		// Palette offset already registered for 'key' this frame, or registers and returns 'paletteOffset'
+		uint32_t Acquire(const Key& key, uint32_t paletteOffset);
+		// Forgets all palettes, has to be called before the first Acquire of every frame
+		void Clear();
+
+		inline uint32_t Entries() const { return static_cast<uint32_t>(m_palettes.size()); }
+		// Acquires since the last Clear that reused a palette
+		inline uint32_t Hits() const { return m_hits; }
+	};
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "vk/buffer.hpp"
+
+#include <deque>
+
+namespace democollection::vk
+{
+	// Persistently mapped upload buffer used as a ring. Data is copied in with
+	// Push, and everything pushed between two CloseRegion calls forms a region
+	// guarded by the fence of the submission that reads it. Space is reclaimed
+	// as those fences signal, so uploads only wait when the ring is full of
+	// data the GPU has not consumed yet.
+	class StagingRing
+	{
+		StagingRing(const StagingRing&) = delete;
+		StagingRing(StagingRing&&) = delete;
+		void operator=(const StagingRing&) = delete;
+		void operator=(StagingRing&&) = delete;
+
+		struct Region
+		{
+			VkDeviceSize begin;
+			VkFence fence;
+		};
+
+	private:
+		const Vulkan& m_vulkan;
+		std::unique_ptr<vk::Buffer> m_buffer;
+		uint8_t* m_data;
+		VkDeviceSize m_capacity;
+		VkDeviceSize m_head;			// where the next push goes
+		VkDeviceSize m_pendingBegin;	// start of the pushes not yet in a region
+		std::deque<Region> m_regions;	// submitted, oldest first
+		std::vector<VkFence> m_freeFences;
+		uint64_t m_closedRegions;
+		uint64_t m_retiredRegions;
+
+	private:
+		inline VkDeviceSize Tail() const { return m_regions.empty() ? m_pendingBegin : m_regions.front().begin; }
+		// Recycles the oldest region, waiting for its fence if 'wait' is set; false if it is still in use
+		bool RetireOldest(bool wait);
+		void Grow(VkDeviceSize size);
+
+	public:
+		static constexpr VkDeviceSize DEFAULT_CAPACITY = 32ull << 20;
+		// Covers texel sizes and the optimal copy offset alignment of common devices
+		static constexpr VkDeviceSize COPY_ALIGNMENT = 16;
+
+		StagingRing(const Vulkan& vulkan, VkDeviceSize capacity = DEFAULT_CAPACITY);
+		~StagingRing();
+
+		// Copies 'size' bytes into the ring and returns their offset in Get(). Waits for
+		// submitted regions to make room. Returns false if the ring is full of pushes that
+		// have not been submitted yet, they have to be submitted before trying again.
+		bool Push(const void* data, VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize alignment = COPY_ALIGNMENT);
+		// Ends the region of the pushes since the last call and returns the fence its
+		// submission has to signal. Regions are numbered from 1 in closing order, the
+		// new one is ClosedRegions().
+		VkFence CloseRegion();
+		// Recycles the regions whose fences have signaled
+		void Retire();
+		// Waits for every closed region
+		void WaitIdle();
+
+		inline VkBuffer Get() const { return m_buffer->Get(); }
+		inline VkDeviceSize Capacity() const { return m_capacity; }
+		inline bool HasPending() const { return m_head != m_pendingBegin; }
+		inline uint64_t ClosedRegions() const { return m_closedRegions; }
+		// Regions are retired in order, so every region up to this one is complete
+		inline uint64_t RetiredRegions() const { return m_retiredRegions; }
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "vk/buffer.hpp"
+
+namespace democollection::vk
+{
+	// Host written storage buffer with one copy per frame in flight, mapped for its whole lifetime
+	class StorageBuffer : public PerFrameBuffer
+	{
+		void* m_mappedData;
+
+	public:
+		StorageBuffer(const Vulkan& vulkan, VkDeviceSize size);
+
+		template <typename T = void*>
+		inline T* Data() const
+		{
+			return reinterpret_cast<T*>(
+					reinterpret_cast<uint8_t*>(m_mappedData) + m_stride * m_vulkan.CurrentFrame()
+					);
+		}
+	};
+}
@@ -14,7 +14,7 @@ namespace democollection::vk
 		const Vulkan& m_vulkan;
 		VkImage m_image;
 		VkImageView m_view;
-		VkDeviceMemory m_memory;
+		Allocation m_memory;
 		VkSampler m_sampler;
 
 	protected:
@@ -27,9 +27,9 @@ namespace democollection::vk
 	private:
 		void Init(const void* pixels, uint32_t width, uint32_t height);
 		void CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels);
-		void TransitionImageLayout(uint32_t mipLevels);
-		void CopyBufferToImage(VkBuffer buffer, uint32_t width, uint32_t height);
-		void GenerateMipmaps(uint32_t width, uint32_t height, uint32_t mipLevels);
+		void TransitionImageLayout(VkCommandBuffer commandBuffer, uint32_t mipLevels);
+		void CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t width, uint32_t height);
+		void GenerateMipmaps(VkCommandBuffer commandBuffer, uint32_t width, uint32_t height, uint32_t mipLevels);
 		void CreateImageView(uint32_t mipLevels);
 		void CreateSampler(uint32_t mipLevels);
 
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common.hpp"
+
+namespace democollection::vk
+{
+	// Two level segregated fit allocator over the offsets [0, size) of a memory
+	// block. Free ranges sit in lists by size class, the first level is the
+	// power of two of the size and the second level splits that into SL_COUNT
+	// steps; two bitmaps find a list that fits in constant time. Freed ranges
+	// are merged with their free neighbours right away. Only offsets are
+	// managed, the memory itself is never touched.
+	//
+	// Handles carry the generation of their range next to its index. Freeing
+	// a range bumps its generation, so a stale handle is rejected even after
+	// its index has been handed out again.
+	class Tlsf
+	{
+	public:
+		using Handle = uint64_t;
+		static constexpr Handle NONE = UINT64_MAX;
+
+	private:
+		static constexpr uint32_t SL_BITS = 3;
+		static constexpr uint32_t SL_COUNT = 1 << SL_BITS;
+		static constexpr uint32_t FL_COUNT = 64;
+		static constexpr uint32_t NO_RANGE = UINT32_MAX;
+
+		struct Range
+		{
+			VkDeviceSize offset;
+			VkDeviceSize size;
+			uint32_t prevPhysical;	// neighbours in memory
+			uint32_t nextPhysical;
+			uint32_t prevFree;		// neighbours in the free list of the size class
+			uint32_t nextFree;
+			uint32_t generation;	// of the handles to the range, kept when the index is reused
+			bool free;
+		};
+
+	private:
+		std::vector<Range> m_ranges;
+		std::vector<uint32_t> m_unusedRanges;
+		uint64_t m_flBitmap;
+		uint32_t m_slBitmaps[FL_COUNT];
+		uint32_t m_freeLists[FL_COUNT][SL_COUNT];
+		VkDeviceSize m_size;
+		VkDeviceSize m_used;
+		uint32_t m_allocationCount;
+
+	private:
+		static void Mapping(VkDeviceSize size, uint32_t& fl, uint32_t& sl);
+		uint32_t NewRange(VkDeviceSize offset, VkDeviceSize size);
+		void InsertFree(uint32_t range);
+		void RemoveFree(uint32_t range);
+		// Merges 'second' into its physical predecessor 'first'
+		void Merge(uint32_t first, uint32_t second);
+
+	public:
+		explicit Tlsf(VkDeviceSize size = 0);
+
+		// Handle of the new range or NONE if nothing fits; 'offset' receives its aligned start
+		Handle Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+		// Throws for handles that are not allocated, including double frees
+		void Free(Handle handle);
+
+		inline VkDeviceSize Size() const { return m_size; }
+		inline VkDeviceSize Used() const { return m_used; }
+		inline uint32_t AllocationCount() const { return m_allocationCount; }
+		inline bool Empty() const { return m_allocationCount == 0; }
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "vk/stagingring.hpp"
+
+#include <chrono>
+
+namespace democollection::vk
+{
+	// Collects uploads, layout transitions and mip blits into one command buffer and
+	// submits them together with a single fence, the fence of the staging ring region
+	// they read. The batch is submitted once it stages enough data or gets old enough,
+	// when the ring needs the space back, and at the start of every frame, so loading
+	// many resources costs a handful of queue submissions instead of several each.
+	//
+	// With a dedicated transfer queue the copies run there, next to rendering. Every
+	// upload is then handed over to the graphics family, released on the transfer
+	// queue and acquired by a graphics command buffer that waits for the copies on a
+	// semaphore. Without one both command buffers are the same.
+	class TransferBatch
+	{
+		TransferBatch(const TransferBatch&) = delete;
+		TransferBatch(TransferBatch&&) = delete;
+		void operator=(const TransferBatch&) = delete;
+		void operator=(TransferBatch&&) = delete;
+
+		struct Submission
+		{
+			VkCommandBuffer transferCommandBuffer;	// null without a dedicated transfer queue
+			VkCommandBuffer graphicsCommandBuffer;
+			VkSemaphore semaphore;					// transfer to graphics handoff
+			uint64_t region;						// staging ring region guarding it
+		};
+
+	private:
+		const Vulkan& m_vulkan;
+		StagingRing& m_staging;
+		const bool m_dedicated;
+		// recording, null if nothing is
+		VkCommandBuffer m_transferCommandBuffer;
+		VkCommandBuffer m_graphicsCommandBuffer;
+		std::deque<Submission> m_submissions;	// in flight, oldest first
+		std::vector<VkCommandBuffer> m_freeTransferCommandBuffers;
+		std::vector<VkCommandBuffer> m_freeGraphicsCommandBuffers;
+		std::vector<VkSemaphore> m_freeSemaphores;
+		VkDeviceSize m_stagedBytes;
+		std::chrono::steady_clock::time_point m_recordStart;
+
+	private:
+		void Retire();
+		VkCommandBuffer Begin(VkCommandPool pool, std::vector<VkCommandBuffer>& freeCommandBuffers);
+
+	public:
+		static constexpr VkDeviceSize FLUSH_BYTES = StagingRing::DEFAULT_CAPACITY / 2;
+		static constexpr std::chrono::milliseconds FLUSH_AGE{10};
+
+		TransferBatch(const Vulkan& vulkan, StagingRing& staging);
+		~TransferBatch();
+
+		// Copies 'data' into the staging ring and returns its offset in StagingBuffer().
+		// Call it before recording, it may submit the batch to make room.
+		VkDeviceSize Stage(const void* data, VkDeviceSize size);
+		// Command buffers to record copies and everything else into, valid until the next Stage or Submit
+		VkCommandBuffer TransferCommandBuffer();
+		VkCommandBuffer GraphicsCommandBuffer();
+		// Moves what the transfer command buffer wrote to the graphics family, nothing to do
+		// without a dedicated transfer queue. The image keeps 'layout'.
+		void HandOver(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size);
+		void HandOver(VkImage image, VkImageLayout layout, uint32_t mipLevels);
+		// Stages 'data', records its copy to 'dst' and hands it over
+		void CopyToBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+		// Submits everything recorded so far without waiting for it
+		void Submit();
+
+		inline VkBuffer StagingBuffer() const { return m_staging.Get(); }
+		inline bool IsRecording() const { return m_transferCommandBuffer || m_graphicsCommandBuffer; }
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
-#include "mth/linalg.hpp"
+#include "mth/layout.hpp"
+
+#include <cstddef>
 
 namespace democollection::vk
 {
@@ -12,32 +14,74 @@ namespace democollection::vk
 		float boneWeights[4];
 		uint32_t boneIndices[4];
 	};
+	// The skinning shader reads vertices as a plain float array
+	static_assert(sizeof(Vertex) == 16 * sizeof(float));
 
-	struct Bone
+	// Written by the skinning shader once per frame, read by every pass. It carries
+	// the texcoord along so draws need no second stream at another offset.
+	struct SkinnedVertex
 	{
-		mth::float4x4 toLocalTransform = mth::Identity<float, 4>();
-		mth::float4x4 boneTransform = mth::Identity<float, 4>();
-		mth::float4x4 toGlobalTransform = mth::Identity<float, 4>();
-		Bone* parent = nullptr;
+		mth::float3 position;
+		mth::float3 normal;
+		mth::float2 texcoord;
 	};
+	static_assert(sizeof(SkinnedVertex) == 8 * sizeof(float));
+	// local_size_x of skinning.comp
+	constexpr uint32_t SKINNING_GROUP_SIZE = 64;
 
+	struct SkinningPushConstants
+	{
+		uint32_t vertexCount;
+		uint32_t paletteOffset;	// first float4 of the model's palette in the arena
+		uint32_t firstVertex;	// of the mesh's source vertices in the geometry arena
+		uint32_t firstSkinnedVertex;	// of the model's skinned vertices, the mesh is shared by instances
+		// palettes are in model space so instances can share them, this places the skinned vertices
+		alignas(mth::LayoutAlignment<mth::Layout::Std430, mth::Affine3x4f>) mth::Affine3x4f world;
+	};
+	static_assert(mth::MatchesLayout<mth::Layout::Std430, SkinningPushConstants, uint32_t, uint32_t, uint32_t, uint32_t, mth::Affine3x4f>(
+		offsetof(SkinningPushConstants, vertexCount),
+		offsetof(SkinningPushConstants, paletteOffset),
+		offsetof(SkinningPushConstants, firstVertex),
+		offsetof(SkinningPushConstants, firstSkinnedVertex),
+		offsetof(SkinningPushConstants, world)));
+
+	// Structs below are copied as is into uniform buffers, so they follow std140
 	struct SceneBufferVs
 	{
 		mth::float4x4 cameraMatrix;
 	};
+	static_assert(mth::MatchesLayout<mth::Layout::Std140, SceneBufferVs, mth::float4x4>(
+		offsetof(SceneBufferVs, cameraMatrix)));
 
 	struct SceneBufferFs
 	{
 		mth::float4 lightPosition;
 		mth::float4 lightColor;
-		int padding[8];
 	};
+	static_assert(mth::MatchesLayout<mth::Layout::Std140, SceneBufferFs, mth::float4, mth::float4>(
+		offsetof(SceneBufferFs, lightPosition),
+		offsetof(SceneBufferFs, lightColor)));
 
+	// Element of the material storage buffer, std430
 	struct ModelBufferFs
 	{
 		mth::float4 diffuseColor;
-		mth::float3 specularColor;
+		alignas(mth::LayoutAlignment<mth::Layout::Std430, mth::float3>) mth::float3 specularColor;
 		float specularPower;
-		int padding[8];
 	};
+	static_assert(mth::MatchesLayout<mth::Layout::Std430, ModelBufferFs, mth::float4, mth::float3, float>(
+		offsetof(ModelBufferFs, diffuseColor),
+		offsetof(ModelBufferFs, specularColor),
+		offsetof(ModelBufferFs, specularPower)));
+	// the array stride is the size rounded up to the vec4 alignment
+	static_assert(sizeof(ModelBufferFs) % sizeof(mth::float4) == 0);
+
+	struct MaterialPushConstants
+	{
+		uint32_t materialIndex;	// into the material storage buffer
+	};
+
+	// The bone palette is a plain vec4 array: three per bone for matrices, two for dual quaternions
+	static_assert(mth::LayoutStride<mth::Layout::Std430, mth::Affine3x4f> == sizeof(mth::Affine3x4f));
+	static_assert(mth::LayoutStride<mth::Layout::Std430, mth::float4> == sizeof(mth::float4));
 }
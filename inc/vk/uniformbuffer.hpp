@@ -13,7 +13,7 @@ namespace democollection::vk
 		inline T* Data() const
 		{
 			return reinterpret_cast<T*>(
-					reinterpret_cast<uint8_t*>(m_mappedData) + m_size * m_vulkan.CurrentFrame()
+					reinterpret_cast<uint8_t*>(m_mappedData) + m_stride * m_vulkan.CurrentFrame()
 					);
 		}
 	};
@@ -1,11 +1,23 @@
 #pragma once
 
 #include "physicaldevice.hpp"
+#include "memoryallocator.hpp"
 
 namespace democollection::vk
 {
 	constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 
+	class StagingRing;
+	class TransferBatch;
+	class DeletionQueue;
+
+	enum class SkinningMode : uint32_t
+	{
+		Linear,			// blended mat3x4 palette
+		DualQuaternion,	// blended vec4[2] palette, keeps volume around twisting joints
+		Count
+	};
+
 	class VulkanResources
 	{
 		VulkanResources(const VulkanResources&) = delete;
@@ -21,21 +33,26 @@ namespace democollection::vk
 #endif
 		VkSurfaceKHR m_surface;
 		VkDevice m_device;
+		std::unique_ptr<MemoryAllocator> m_memoryAllocator;
 		VkSwapchainKHR m_swapchain;
 		std::vector<VkImage> m_swapchainImages;
 		std::vector<VkImageView> m_swapchainImageViews;
 		std::vector<VkFramebuffer> m_swapchainFrameBuffers;
 		VkImage m_colorImage;
-		VkDeviceMemory m_colorImageMemory;
+		Allocation m_colorImageMemory;
 		VkImageView m_colorImageView;
 		VkImage m_depthImage;
-		VkDeviceMemory m_depthImageMemory;
+		Allocation m_depthImageMemory;
 		VkImageView m_depthImageView;
 		VkRenderPass m_renderPass;
 		VkDescriptorSetLayout m_descriptorSetLayout;
 		VkPipelineLayout m_pipelineLayout;
 		VkPipeline m_graphicsPipeline;
+		VkDescriptorSetLayout m_skinningDescriptorSetLayout;
+		VkPipelineLayout m_skinningPipelineLayout;
+		VkPipeline m_skinningPipelines[static_cast<uint32_t>(SkinningMode::Count)];
 		VkCommandPool m_commandPool;
+		VkCommandPool m_transferCommandPool;	// only with a dedicated transfer queue
 		VkCommandBuffer m_commandBuffers[MAX_FRAMES_IN_FLIGHT];
 		VkSemaphore m_imageAvailableSemaphore[MAX_FRAMES_IN_FLIGHT];
 		VkSemaphore m_renderFinishedSemaphore[MAX_FRAMES_IN_FLIGHT];
@@ -68,11 +85,15 @@ namespace democollection::vk
 		GLFWwindow* m_window;
 		VkQueue m_graphicsQueue;
 		VkQueue m_presentQueue;
+		VkQueue m_transferQueue;
 		PhysicalDevice m_physicalDevice;
 		VkExtent2D m_swapchainExtent;
 		uint32_t m_currentFrame;
 		uint32_t m_imageIndex;
 		bool m_resizeRequested;
+		std::unique_ptr<StagingRing> m_stagingRing;
+		std::unique_ptr<TransferBatch> m_transferBatch;
+		std::unique_ptr<DeletionQueue> m_deletionQueue;
 
 	private:
 		void CreateInstance(const char* name);
@@ -88,31 +109,51 @@ namespace democollection::vk
 		void CreateDescriptorSetLayout();
 		ShaderModule CreateShaderModule(const std::vector<char>& code) const;
 		void CreateGraphicsPipeline();
+		void CreateSkinningPipeline();
 		void CreateFrameBuffers();
 		void CreateCommandPool();
 		void CreateCommandBuffers();
 		void CreateSyncObjects();
 
-		void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) const;
+		void RecordCommandBuffer(VkCommandBuffer commandBuffer) const;
 
 	public:
 		Vulkan(const char* name, GLFWwindow* window);
+		~Vulkan();
 		void RecreateSwapchain();
-		bool BeginRender();
+		// Begins the frame's command buffer, returns false if the frame has to be skipped
+		bool BeginFrame();
+		// Makes the skinned vertices visible to the vertex input and begins the render pass
+		void BeginRender();
 		void EndRender();
 
 		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
-		VkDeviceMemory AllocateMemory(VkImage image) const;
+		Allocation AllocateMemory(VkImage image, MemoryCategory category) const;
 
-		inline void Flush() const { vkDeviceWaitIdle(m_device); }
+		// Submits pending uploads, waits for the device and releases every deferred resource
+		void Flush() const;
 		inline void RequestResize() { m_resizeRequested = true; }
 
 		inline const PhysicalDevice& Gpu() const { return m_physicalDevice; }
 		inline VkDevice Device() const { return m_device; }
+		// Every resource takes its memory from here
+		inline MemoryAllocator& Memory() const { return *m_memoryAllocator; }
+		// Uploads go through here instead of creating their own staging buffers
+		inline StagingRing& Staging() const { return *m_stagingRing; }
+		// Records uploads, submitted at the latest when the next frame begins
+		inline TransferBatch& Transfers() const { return *m_transferBatch; }
+		// Resources release their handles through here, after the frames using them are done
+		inline DeletionQueue& Deletions() const { return *m_deletionQueue; }
 		inline VkCommandPool CommandPool() const { return m_commandPool; }
+		inline VkCommandPool TransferCommandPool() const { return m_transferCommandPool; }
 		inline VkDescriptorSetLayout DescriptorSetLayout() const { return m_descriptorSetLayout; }
 		inline VkPipelineLayout PipelineLayout() const { return m_pipelineLayout; }
+		inline VkDescriptorSetLayout SkinningDescriptorSetLayout() const { return m_skinningDescriptorSetLayout; }
+		inline VkPipelineLayout SkinningPipelineLayout() const { return m_skinningPipelineLayout; }
+		inline VkPipeline SkinningPipeline(SkinningMode mode) const { return m_skinningPipelines[static_cast<uint32_t>(mode)]; }
 		inline VkQueue Queue() const { return m_graphicsQueue; }
+		// The graphics queue if the device has no dedicated transfer queue
+		inline VkQueue TransferQueue() const { return m_transferQueue; }
 		inline VkCommandBuffer CommandBuffer() const { return m_commandBuffers[m_currentFrame]; }
 		inline uint32_t CurrentFrame() const { return m_currentFrame; }
 		inline VkAllocationCallbacks* Allocator() const { return VulkanResources::Allocator(); }
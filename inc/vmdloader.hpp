@@ -0,0 +1,37 @@
+#pragma once
+
+#include "motion.hpp"
+#include "common.hpp"
+
+namespace democollection
+{
+	// Reads the bone keyframes of a VMD (MikuMikuDance motion) file. Morph,
+	// camera and light keyframes are ignored.
+	class VmdLoader
+	{
+	public:
+		enum Status
+		{
+			Ok,
+			FileNotFound,
+			SignatureError,
+			BoneError
+		};
+
+	private:
+		Motion& m_motion;
+		std::ifstream m_infile;
+		std::string m_modelName;
+		Status m_status;
+
+	private:
+		Status Load();
+		Status LoadHeader();
+		Status LoadBoneKeyframes();
+
+	public:
+		VmdLoader(Motion& motion, const char filename[]);
+		Status StatusInfo() const { return m_status; }
+		const std::string& ModelName() const { return m_modelName; }
+	};
+}
@@ -6,12 +6,23 @@ layout (binding = 2) uniform SceneBuffer
 	vec4 lightColor;
 } sceneBuffer;
 
-layout (binding = 3) uniform ModelBuffer
+struct Material
 {
 	vec4 diffuseColor;
 	vec3 specularColor;
 	float specularPower;
-} modelBuffer;
+};
+
+// Materials of all models, bound for the shading to come; the output does not use them yet
+layout (std430, binding = 3) readonly buffer Materials
+{
+	Material materials[];
+};
+
+layout (push_constant) uniform PushConstants
+{
+	uint materialIndex;
+};
 
 layout (binding = 4) uniform sampler2D texSampler;
 
@@ -23,7 +34,7 @@ layout (location = 0) out vec4 outColor;
 
 void main()
 {
-	float shade = clamp(0.0f, 1.0f, dot(fragNormal, normalize(sceneBuffer.lightPosition.xyz - fragPosition)));
+	float shade = clamp(dot(fragNormal, normalize(sceneBuffer.lightPosition.xyz - fragPosition)), 0.0f, 1.0f);
 	vec4 color = texture(texSampler, fragTexcoord);
 	outColor = (shade * 0.5f + 0.5f) * color;
 }
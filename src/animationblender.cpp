@@ -0,0 +1,122 @@
+#include "animationblender.hpp"
+#include "common.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace democollection
+{
+	float AnimationBlender::ClipFrame(const Clip& clip, float time)
+	{
+		// motions loop
+		const float frameCount = static_cast<float>(clip.animator->GetMotion().LastFrame() + 1);
+		const float frame = std::fmod((time - clip.startTime) * Motion::FRAMES_PER_SECOND, frameCount);
+		return frame < 0.0f ? frame + frameCount : frame;
+	}
+
+	void AnimationBlender::SampleClip(Clip& clip, float time, Pose& pose)
+	{
+		pose.SetIdentity();
+		if (clip.animator)
+			clip.animator->Sample(ClipFrame(clip, time), pose);
+	}
+
+	AnimationBlender::AnimationBlender(const Skeleton& skeleton)
+		: m_skeleton{skeleton}
+		, m_fullMask(skeleton.Size(), 1.0f)
+		, m_result(skeleton.Size())
+		, m_layerPose(skeleton.Size())
+		, m_clipPose(skeleton.Size())
+	{
+		AddLayer(LayerMode::Override);
+	}
+
+	std::vector<float> AnimationBlender::MaskFromBone(const Skeleton& skeleton, int bone)
+	{
+		// parents come first, so one pass sees every ancestor before its children
+		std::vector<float> mask(skeleton.Size(), 0.0f);
+		for (size_t i = 0; i < skeleton.Size(); ++i)
+			if (static_cast<int>(i) == bone || (skeleton.Parent(i) >= 0 && mask[skeleton.Parent(i)] > 0.0f))
+				mask[i] = 1.0f;
+		return mask;
+	}
+
+	size_t AnimationBlender::AddLayer(LayerMode mode, float weight, std::vector<float> mask)
+	{
+		ThrowIfFalse(mask.empty() || mask.size() == m_skeleton.Size(), "The layer mask does not match the skeleton");
+
+		Layer layer{};
+		layer.mode = mode;
+		layer.weight = weight;
+		layer.mask = mask.empty() ? m_fullMask : std::move(mask);
+		m_layers.push_back(std::move(layer));
+		return m_layers.size() - 1;
+	}
+
+	void AnimationBlender::Play(size_t layer, std::shared_ptr<const CompressedMotion> motion, float time, float fadeDuration)
+	{
+		Layer& l = m_layers[layer];
+		// a fade that is still running is cut short, the clip it faded from is dropped
+		l.previous = std::move(l.current);
+		l.current.animator = motion ? std::make_unique<Animator>(m_skeleton, std::move(motion)) : nullptr;
+		l.current.startTime = time;
+		l.fadeStart = time;
+		l.fadeDuration = fadeDuration;
+		if (fadeDuration <= 0.0f)
+			l.previous.animator.reset();
+	}
+
+	void AnimationBlender::Evaluate(float time, Skeleton& skeleton)
+	{
+		m_result.SetIdentity();
+		for (Layer& layer : m_layers)
+		{
+			if (layer.previous.animator)
+			{
+				const float t = std::clamp((time - layer.fadeStart) / layer.fadeDuration, 0.0f, 1.0f);
+				if (t >= 1.0f)
+					layer.previous.animator.reset();
+				else
+				{
+					SampleClip(layer.previous, time, m_layerPose);
+					SampleClip(layer.current, time, m_clipPose);
+					BlendPoses(m_layerPose, m_layerPose, m_clipPose, t * t * (3.0f - 2.0f * t), m_fullMask.data());
+				}
+			}
+			if (!layer.previous.animator)
+			{
+				if (!layer.current.animator)
+					continue;
+				SampleClip(layer.current, time, m_layerPose);
+			}
+
+			if (layer.mode == LayerMode::Additive)
+				AddPoses(m_result, m_result, m_layerPose, layer.weight, layer.mask.data());
+			else
+				BlendPoses(m_result, m_result, m_layerPose, layer.weight, layer.mask.data());
+		}
+		m_result.Apply(skeleton);
+	}
+
+	const CompressedMotion* AnimationBlender::SingleClip(float time, float& frame) const
+	{
+		// any other layer or a running fade makes the pose depend on more than one clip
+		if (m_layers.size() != 1)
+			return nullptr;
+		const Layer& layer = m_layers.front();
+		if (!layer.current.animator || layer.weight != 1.0f || layer.mask != m_fullMask ||
+				(layer.previous.animator && time < layer.fadeStart + layer.fadeDuration))
+			return nullptr;
+		frame = ClipFrame(layer.current, time);
+		return &layer.current.animator->GetMotion();
+	}
+
+	void AnimationBlender::EvaluateFrame(float frame, Skeleton& skeleton)
+	{
+		Layer& layer = m_layers.front();
+		layer.previous.animator.reset();
+		m_result.SetIdentity();
+		layer.current.animator->Sample(frame, m_result);
+		m_result.Apply(skeleton);
+	}
+}
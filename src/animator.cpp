@@ -0,0 +1,187 @@
+#include "animator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace democollection
+{
+	// Rotation of a keyframe from the packed smallest three
+	static inline void UnpackRotation(uint32_t p0, uint32_t p1, uint32_t p2, float& x, float& y, float& z, float& w)
+	{
+		const uint32_t largest = (p0 >> 15) | ((p1 >> 15) << 1);
+		const float scale = 2.0f * CompressedMotion::ROTATION_RANGE / CompressedMotion::ROTATION_MAX;
+		const float a = static_cast<float>(p0 & 0x7fff) * scale - CompressedMotion::ROTATION_RANGE;
+		const float b = static_cast<float>(p1 & 0x7fff) * scale - CompressedMotion::ROTATION_RANGE;
+		const float c = static_cast<float>(p2) * scale - CompressedMotion::ROTATION_RANGE;
+		const float d = std::sqrt(std::max(1.0f - a * a - b * b - c * c, 0.0f));
+		// the stored components are the remaining ones in order, selects keep the loop branch free
+		x = largest == 0 ? d : a;
+		y = largest == 0 ? a : largest == 1 ? d : b;
+		z = largest <= 1 ? b : largest == 2 ? d : c;
+		w = largest == 3 ? d : c;
+	}
+
+	void Animator::DecodeBuffers::Resize(size_t count)
+	{
+		for (size_t k = 0; k < 2; ++k)
+		{
+			for (size_t c = 0; c < 3; ++c)
+			{
+				rotations[k][c].resize(count);
+				translations[k][c].resize(count);
+			}
+		}
+		for (size_t c = 0; c < 3; ++c)
+		{
+			translationMin[c].resize(count);
+			translationScale[c].resize(count);
+			outTranslations[c].resize(count);
+		}
+		for (size_t c = 0; c < 4; ++c)
+		{
+			weights[c].resize(count);
+			outRotations[c].resize(count);
+		}
+	}
+
+	uint32_t Animator::FindKeyframe(const CompressedMotion::Keyframe* keyframes, uint32_t count, float frame, uint32_t cursor)
+	{
+		// during playback the cached keyframe or the one after it is almost always the right one
+		if (cursor < count && keyframes[cursor].frame <= frame)
+		{
+			if (cursor + 1 == count || frame < keyframes[cursor + 1].frame)
+				return cursor;
+			if (cursor + 2 == count || frame < keyframes[cursor + 2].frame)
+				return cursor + 1;
+		}
+		const CompressedMotion::Keyframe* it = std::upper_bound(keyframes, keyframes + count, frame, [](float f, const CompressedMotion::Keyframe& k)->bool{
+			return f < k.frame;
+		});
+		return it == keyframes ? 0 : static_cast<uint32_t>(it - keyframes - 1);
+	}
+
+	Animator::Animator(const Skeleton& skeleton, std::shared_ptr<const CompressedMotion> motion)
+		: m_motion{std::move(motion)}
+	{
+		const std::vector<CompressedMotion::Track>& tracks = m_motion->Tracks();
+		for (size_t i = 0; i < tracks.size(); ++i)
+		{
+			const int bone = skeleton.FindBone(tracks[i].boneName);
+			if (bone >= 0 && tracks[i].keyframeCount > 0)
+				m_bindings.push_back(Binding{static_cast<uint32_t>(i), static_cast<uint32_t>(bone), 0});
+		}
+		// parent first, like the skeleton itself
+		std::sort(m_bindings.begin(), m_bindings.end(), [](const Binding& lhs, const Binding& rhs)->bool{
+			return lhs.bone < rhs.bone;
+		});
+		m_decode.Resize(m_bindings.size());
+	}
+
+	void Animator::Decode(float frame)
+	{
+		// gather the keyframes around 'frame' and evaluate their curves, this part is per track
+		DecodeBuffers& d = m_decode;
+		const size_t count = m_bindings.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			Binding& binding = m_bindings[i];
+			const CompressedMotion::Track& track = m_motion->Tracks()[binding.track];
+			const CompressedMotion::Keyframe* keyframes = m_motion->Keyframes(track);
+			binding.cursor = FindKeyframe(keyframes, track.keyframeCount, frame, binding.cursor);
+
+			const CompressedMotion::Keyframe& k0 = keyframes[binding.cursor];
+			const bool between = binding.cursor + 1 < track.keyframeCount && frame > k0.frame;
+			const CompressedMotion::Keyframe& k1 = between ? keyframes[binding.cursor + 1] : k0;
+			const float t = between ? (frame - k0.frame) / static_cast<float>(k1.frame - k0.frame) : 0.0f;
+			for (size_t c = 0; c < 4; ++c)
+				d.weights[c][i] = between ? CompressedMotion::DecodeCurve(k1, c).Evaluate(t) : 0.0f;
+			for (size_t c = 0; c < 3; ++c)
+			{
+				d.rotations[0][c][i] = k0.rotation[c];
+				d.rotations[1][c][i] = k1.rotation[c];
+				d.translations[0][c][i] = k0.translation[c];
+				d.translations[1][c][i] = k1.translation[c];
+				d.translationMin[c][i] = track.translationMin(c);
+				d.translationScale[c][i] = track.translationScale(c);
+			}
+		}
+
+		// dequantize and interpolate all tracks at once
+		for (size_t c = 0; c < 3; ++c)
+		{
+			const uint32_t* q0 = d.translations[0][c].data();
+			const uint32_t* q1 = d.translations[1][c].data();
+			const float* min = d.translationMin[c].data();
+			const float* scale = d.translationScale[c].data();
+			const float* weight = d.weights[c].data();
+			float* out = d.outTranslations[c].data();
+			#pragma omp simd
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float v0 = static_cast<float>(q0[i]);
+				const float v1 = static_cast<float>(q1[i]);
+				out[i] = min[i] + scale[i] * (v0 + (v1 - v0) * weight[i]);
+			}
+		}
+
+		const uint32_t* a0 = d.rotations[0][0].data();
+		const uint32_t* b0 = d.rotations[0][1].data();
+		const uint32_t* c0 = d.rotations[0][2].data();
+		const uint32_t* a1 = d.rotations[1][0].data();
+		const uint32_t* b1 = d.rotations[1][1].data();
+		const uint32_t* c1 = d.rotations[1][2].data();
+		const float* weight = d.weights[3].data();
+		float* rx = d.outRotations[0].data();
+		float* ry = d.outRotations[1].data();
+		float* rz = d.outRotations[2].data();
+		float* rw = d.outRotations[3].data();
+		#pragma omp simd
+		for (size_t i = 0; i < count; ++i)
+		{
+			float x0, y0, z0, w0, x1, y1, z1, w1;
+			UnpackRotation(a0[i], b0[i], c0[i], x0, y0, z0, w0);
+			UnpackRotation(a1[i], b1[i], c1[i], x1, y1, z1, w1);
+
+			// nlerp with its parameter corrected to follow slerp, within half a degree even for keyframes half a turn apart
+			const float dot = x0 * x1 + y0 * y1 + z0 * z1 + w0 * w1;
+			const float cosa = std::abs(dot);
+			const float k = 0.930224f - 1.251437f * cosa + 0.327494f * cosa * cosa;
+			const float t = weight[i];
+			const float tb = std::copysign(t + t * (t - 0.5f) * (t - 1.0f) * k, dot);
+			const float ta = 1.0f - std::abs(tb);
+			const float x = x0 * ta + x1 * tb;
+			const float y = y0 * ta + y1 * tb;
+			const float z = z0 * ta + z1 * tb;
+			const float w = w0 * ta + w1 * tb;
+			const float invLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+			rx[i] = x * invLength;
+			ry[i] = y * invLength;
+			rz[i] = z * invLength;
+			rw[i] = w * invLength;
+		}
+	}
+
+	void Animator::Sample(float frame, Skeleton& skeleton)
+	{
+		Decode(frame);
+		for (size_t i = 0; i < m_bindings.size(); ++i)
+		{
+			const mth::Quaternionf rotation(m_decode.outRotations[0][i], m_decode.outRotations[1][i], m_decode.outRotations[2][i], m_decode.outRotations[3][i]);
+			const mth::float3 translation(m_decode.outTranslations[0][i], m_decode.outTranslations[1][i], m_decode.outTranslations[2][i]);
+			skeleton.LocalTransform(m_bindings[i].bone) = mth::Affine3x4f(mth::Rotation3x3(rotation), translation);
+		}
+	}
+
+	void Animator::Sample(float frame, Pose& pose)
+	{
+		Decode(frame);
+		for (size_t i = 0; i < m_bindings.size(); ++i)
+		{
+			const uint32_t bone = m_bindings[i].bone;
+			for (size_t c = 0; c < 4; ++c)
+				pose.Rotations(c)[bone] = m_decode.outRotations[c][i];
+			for (size_t c = 0; c < 3; ++c)
+				pose.Translations(c)[bone] = m_decode.outTranslations[c][i];
+		}
+	}
+}
@@ -1,11 +1,25 @@
 #include "application.hpp"
 #include "mth/linalg.hpp"
 #include "modelloader.hpp"
+#include "vmdloader.hpp"
 #include "image.hpp"
 #include <iostream>
 
 namespace democollection
 {
+	// Only the compressed form stays resident, the source motion is freed right away
+	static std::shared_ptr<const CompressedMotion> LoadMotion(const char* filename)
+	{
+		Motion motion;
+		VmdLoader loader(motion, filename);
+		if (loader.StatusInfo() != VmdLoader::Ok)
+		{
+			std::cerr << "Failed to load motion " << filename << std::endl;
+			return nullptr;
+		}
+		return std::make_shared<const CompressedMotion>(motion);
+	}
+
 	void Application::Update()
 	{
 		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
@@ -17,8 +31,49 @@ namespace democollection
 		sceneBufferFs.lightColor = mth::float4(1.0f);
 		sceneBufferFs.lightPosition = mth::float4(m_camera.position(0), m_camera.position(1), m_camera.position(2), 1.0f);
 
-		if (m_model)
-			m_model->Update();
+		const float time = std::chrono::duration<float>(now - m_startTime).count();
+		const std::chrono::steady_clock::time_point deadline = now + (m_zeroAnimationBudget ? std::chrono::microseconds{0} : ANIMATION_BUDGET);
+		const size_t modelCount = m_models.size();
+		std::atomic<size_t> firstSkipped{modelCount};
+		const bool switchMotion = m_motionSwitchRequested && !m_motions.empty();
+		if (switchMotion)
+			m_currentMotion = (m_currentMotion + 1) % m_motions.size();
+		m_motionSwitchRequested = false;
+
+		// decide which models evaluate their pose before animating any of them, the rest reuse their palettes
+		m_poseCache.Clear();
+		for (size_t i = 0; i < modelCount; ++i)
+		{
+			vk::Model& model = *m_models[i];
+			// offset the crowd a little so they do not move in lockstep
+			const float modelTime = time + static_cast<float>(i % CROWD_PHASES) * 0.37f;
+			if (switchMotion)
+				model.Blender().Play(0, m_motions[m_currentMotion], modelTime, MOTION_CROSSFADE_TIME);
+			model.SharePose(m_poseCache, modelTime);
+		}
+
+		m_jobs.ParallelFor(modelCount, [&](size_t i) {
+			const size_t index = (m_animationStart + i) % modelCount;
+			vk::Model& model = *m_models[index];
+			if (model.SharesPose())
+				return;
+			// a model without a pose yet would have only its bind pose to keep
+			if (!model.HasPose() || std::chrono::steady_clock::now() < deadline)
+			{
+				model.Animate(time + static_cast<float>(index % CROWD_PHASES) * 0.37f);
+			}
+			else
+			{
+				size_t skipped = firstSkipped;
+				while (i < skipped && !firstSkipped.compare_exchange_weak(skipped, i));
+			}
+			model.WritePalette();
+		});
+		if (firstSkipped < modelCount)
+			m_animationStart = (m_animationStart + firstSkipped) % modelCount;
+		// sharers draw the palette of a model that does not share, so this covers every drawn palette
+		for (const std::unique_ptr<vk::Model>& model : m_models)
+			ThrowIfFalse(model->SharesPose() || model->HasPose(), "A model draws the bind pose");
 
 		//std::cout << 1.0f / std::chrono::duration<float>(now - m_prevFrameTime).count() << std::endl;
 		m_prevFrameTime = now;
@@ -26,14 +81,47 @@ namespace democollection
 
 	void Application::Render()
 	{
-		if (m_graphics->BeginRender())
+		if (m_graphics->BeginFrame())
 		{
-			if (m_model)
-				m_model->Render();
+			for (const std::unique_ptr<vk::Model>& model : m_models)
+				model->Skin();
+			m_graphics->BeginRender();
+			// every model draws from the same vertex and index buffers
+			if (m_geometryArena)
+				m_geometryArena->Bind(m_graphics->CommandBuffer(), m_graphics->CurrentFrame());
+			for (const std::unique_ptr<vk::Model>& model : m_models)
+				model->Render();
 			m_graphics->EndRender();
 		}
 	}
 
+	void Application::PrintMemoryUsage() const
+	{
+		const vk::MemoryAllocator& allocator = m_graphics->Memory();
+		const vk::MemoryAllocator::Stats memory = allocator.GetStats();
+		std::cout << "Device memory: " << (memory.usedBytes >> 20) << " of " << (memory.reservedBytes >> 20) << " MiB used by "
+				<< memory.allocationCount << " allocations in " << memory.blockCount << " blocks, "
+				<< memory.dedicatedCount << " of them dedicated, peak " << (memory.peakUsedBytes >> 20) << " of "
+				<< (memory.peakReservedBytes >> 20) << " MiB" << std::endl;
+		if (allocator.HasHostVisibleDeviceLocal(UINT32_MAX))
+			std::cout << "  uniform and storage buffers are written straight to device local memory" << std::endl;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(vk::MemoryCategory::Count); ++i)
+		{
+			const vk::MemoryCategory category = static_cast<vk::MemoryCategory>(i);
+			const vk::MemoryAllocator::CategoryStats& stats = allocator.GetStats(category);
+			std::cout << "  " << vk::MemoryAllocator::CategoryName(category) << ": " << (stats.usedBytes >> 10) << " KiB in "
+					<< stats.allocationCount << " allocations, peak " << (stats.peakUsedBytes >> 10) << " KiB" << std::endl;
+		}
+		// without VK_EXT_memory_budget the usage is only ours and the budget is the heap size
+		const std::vector<vk::MemoryAllocator::HeapBudget> budgets = allocator.GetHeapBudgets();
+		for (size_t i = 0; i < budgets.size(); ++i)
+		{
+			std::cout << "  heap " << i << (budgets[i].deviceLocal ? " (device local)" : "") << ": " << (budgets[i].usage >> 20)
+					<< " of " << (budgets[i].budget >> 20) << " MiB budget, " << (budgets[i].reservedBytes >> 20) << " MiB ours, "
+					<< (budgets[i].size >> 20) << " MiB heap" << std::endl;
+		}
+	}
+
 	void Application::Resize(int width, int height)
 	{
 		m_camera.UpdateScreenResolution(width, height);
@@ -55,14 +143,45 @@ namespace democollection
 		m_camController.Scroll(static_cast<float>(y));
 	}
 
+	void Application::Key(int key, int scancode, int action, int modifier)
+	{
+		// K switches between linear blend and dual quaternion skinning
+		if (key == GLFW_KEY_K && action == GLFW_PRESS)
+		{
+			for (const std::unique_ptr<vk::Model>& model : m_models)
+				model->SetSkinningMode(model->GetSkinningMode() == vk::SkinningMode::Linear ?
+						vk::SkinningMode::DualQuaternion : vk::SkinningMode::Linear);
+		}
+		// space crossfades to the next motion
+		if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
+			m_motionSwitchRequested = true;
+		// M prints the device memory usage
+		if (key == GLFW_KEY_M && action == GLFW_PRESS)
+			PrintMemoryUsage();
+		// B toggles a zero animation budget, every model that has a pose keeps it
+		if (key == GLFW_KEY_B && action == GLFW_PRESS)
+			m_zeroAnimationBudget = !m_zeroAnimationBudget;
+	}
+
 	Application::Application()
 		: m_window{}
+		, m_poseCache(POSE_CACHE_FRAME_STEP)
+		, m_animationStart{0}
+		, m_currentMotion{0}
+		, m_motionSwitchRequested{false}
+		, m_zeroAnimationBudget{false}
 		, m_camController(m_camera)
 	{}
 
 	Application::~Application()
 	{
-		m_model.reset();
+		m_models.clear();
+		// the meshes return their ranges to the geometry arena
+		if (m_graphics)
+			m_graphics->Flush();
+		m_paletteArena.reset();
+		m_geometryArena.reset();
+		m_materialArena.reset();
 		m_sceneBufferVs.reset();
 		m_sceneBufferFs.reset();
 		m_graphics.reset();
@@ -92,17 +211,51 @@ namespace democollection
 		glfwSetScrollCallback(m_window, [](GLFWwindow* window, double x, double y)->void{
 			reinterpret_cast<Application*>(glfwGetWindowUserPointer(window))->Scroll(x, y);
 		});
+		glfwSetKeyCallback(m_window, [](GLFWwindow* window, int key, int scancode, int action, int modifier)->void{
+			reinterpret_cast<Application*>(glfwGetWindowUserPointer(window))->Key(key, scancode, action, modifier);
+		});
 
 		m_graphics = std::make_unique<vk::Graphics>(title, m_window);
 		m_sceneBufferVs = std::make_unique<vk::UniformBuffer>(*m_graphics, sizeof(vk::SceneBufferVs));
 		m_sceneBufferFs = std::make_unique<vk::UniformBuffer>(*m_graphics, sizeof(vk::SceneBufferFs));
 
+		// arguments: model [motion [crowd size [more motions...]]]
 		if (argc > 1)
 		{
 			ModelLoader ml;
+			for (int i = 2; i < argc; ++i)
+				if (i != 3)
+					if (std::shared_ptr<const CompressedMotion> motion = LoadMotion(argv[i]))
+						m_motions.push_back(std::move(motion));
+			const int crowdSize = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1;
+			const int rowSize = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(crowdSize))));
 			if (ml.LoadPmx(argv[1]))
-				m_model = std::make_unique<vk::Model>(*m_graphics, *m_sceneBufferVs, *m_sceneBufferFs, ml);
+			{
+				const uint32_t boneCount = static_cast<uint32_t>(std::max<size_t>(ml.Skeleton().Size(), 1));
+				m_paletteArena = std::make_unique<vk::PaletteArena>(*m_graphics, boneCount * crowdSize);
+				// the crowd shares one copy of the source geometry, only the skinned vertices are per model
+				const uint32_t vertexCount = static_cast<uint32_t>(ml.Vertices().size());
+				const uint32_t indexCount = static_cast<uint32_t>(ml.Indices().size());
+				m_geometryArena = std::make_unique<vk::GeometryArena>(*m_graphics, vertexCount, indexCount, vertexCount * crowdSize);
+				const std::shared_ptr<const vk::Mesh> mesh = std::make_shared<const vk::Mesh>(*m_graphics, *m_geometryArena,
+						ml.Vertices().data(), vertexCount, ml.Indices().data(), indexCount);
+				// the crowd shares one copy of the materials
+				m_materialArena = std::make_unique<vk::MaterialArena>(*m_graphics, static_cast<uint32_t>(ml.Materials().size()));
+				const uint32_t firstMaterial = m_materialArena->Add(ml.Materials());
+				for (int i = 0; i < crowdSize; ++i)
+				{
+					std::unique_ptr<vk::Model> model = std::make_unique<vk::Model>(*m_graphics, *m_sceneBufferVs, *m_sceneBufferFs, *m_paletteArena, *m_geometryArena, mesh, *m_materialArena, firstMaterial, ml);
+					const float spacing = 10.0f;
+					model->SetWorldTransform(mth::Translation3x4(mth::float3(
+						(i % rowSize - (rowSize - 1) * 0.5f) * spacing,
+						0.0f,
+						(i / rowSize) * spacing)));
+					model->SetMotion(m_motions.empty() ? nullptr : m_motions.front());
+					m_models.push_back(std::move(model));
+				}
+			}
 		}
+		PrintMemoryUsage();
 
 		m_camera.UpdateScreenResolution(width, height);
 		m_camController.SetCenter(mth::float3(0.0f, -10.0f, 0.0f));
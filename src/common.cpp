@@ -1,6 +1,7 @@
 #include "common.hpp"
 
 #include <fstream>
+#include <iconv.h>
 
 namespace democollection
 {
@@ -54,6 +55,25 @@ namespace democollection
 		return {};
 	}
 
+	std::string ShiftJisToUtf8(const char* text, size_t length)
+	{
+		iconv_t cd = iconv_open("UTF-8", "CP932");
+		if (cd == reinterpret_cast<iconv_t>(-1))
+			return std::string(text, length);
+
+		// every Shift JIS byte becomes at most 3 UTF-8 bytes
+		std::string result(length * 3, '\0');
+		char* in = const_cast<char*>(text);
+		char* out = result.data();
+		size_t inLeft = length;
+		size_t outLeft = result.size();
+		// stops at the first invalid or cut off character, the text converted so far is kept
+		iconv(cd, &in, &inLeft, &out, &outLeft);
+		iconv_close(cd);
+		result.resize(result.size() - outLeft);
+		return result;
+	}
+
 	std::vector<char> ReadFile(const char* filename)
 	{
 		std::ifstream infile(filename, std::ios::binary | std::ios::ate);
@@ -0,0 +1,124 @@
+#include "compressedmotion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace democollection
+{
+	void CompressedMotion::EncodeRotation(const mth::Quaternionf& q, uint16_t out[3])
+	{
+		const float c[4] = {q.x, q.y, q.z, q.w};
+		size_t largest = 0;
+		for (size_t i = 1; i < 4; ++i)
+			if (std::abs(c[i]) > std::abs(c[largest]))
+				largest = i;
+		// q and -q are the same rotation, flip so the dropped component is positive
+		const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+		for (size_t i = 0, j = 0; i < 4; ++i)
+		{
+			if (i == largest)
+				continue;
+			const float v = std::clamp(c[i] * sign / ROTATION_RANGE * 0.5f + 0.5f, 0.0f, 1.0f);
+			out[j++] = static_cast<uint16_t>(std::lround(v * ROTATION_MAX));
+		}
+		out[0] |= static_cast<uint16_t>((largest & 1) << 15);
+		out[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+	}
+
+	mth::Quaternionf CompressedMotion::DecodeRotation(const uint16_t packed[3])
+	{
+		const size_t largest = (packed[0] >> 15) | ((packed[1] >> 15) << 1);
+		float c[4];
+		float sum = 0.0f;
+		for (size_t i = 0, j = 0; i < 4; ++i)
+		{
+			if (i == largest)
+				continue;
+			c[i] = ((packed[j++] & 0x7fff) / ROTATION_MAX * 2.0f - 1.0f) * ROTATION_RANGE;
+			sum += c[i] * c[i];
+		}
+		c[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+		return mth::Quaternionf(c[0], c[1], c[2], c[3]);
+	}
+
+	Bezier CompressedMotion::DecodeCurve(const Keyframe& keyframe, size_t curve)
+	{
+		Bezier bezier;
+		bezier.x1 = keyframe.curves[curve * 4 + 0] / CURVE_MAX;
+		bezier.y1 = keyframe.curves[curve * 4 + 1] / CURVE_MAX;
+		bezier.x2 = keyframe.curves[curve * 4 + 2] / CURVE_MAX;
+		bezier.y2 = keyframe.curves[curve * 4 + 3] / CURVE_MAX;
+		return bezier;
+	}
+
+	CompressedMotion::CompressedMotion(const Motion& motion)
+		: m_lastFrame{motion.lastFrame}
+	{
+		m_tracks.reserve(motion.boneTracks.size());
+		size_t keyframeCount = 0;
+		for (const BoneTrack& source : motion.boneTracks)
+			keyframeCount += source.keyframes.size();
+		m_keyframes.reserve(keyframeCount);
+		for (const BoneTrack& source : motion.boneTracks)
+		{
+			Track track;
+			track.boneName = source.boneName;
+			track.firstKeyframe = static_cast<uint32_t>(m_keyframes.size());
+			track.keyframeCount = static_cast<uint32_t>(source.keyframes.size());
+			mth::float3 maxTranslation;
+			for (size_t c = 0; c < 3; ++c)
+			{
+				track.translationMin(c) = source.keyframes.empty() ? 0.0f : source.keyframes.front().translation(c);
+				maxTranslation(c) = track.translationMin(c);
+			}
+			for (const BoneKeyframe& k : source.keyframes)
+			{
+				for (size_t c = 0; c < 3; ++c)
+				{
+					track.translationMin(c) = std::min(track.translationMin(c), k.translation(c));
+					maxTranslation(c) = std::max(maxTranslation(c), k.translation(c));
+				}
+			}
+			for (size_t c = 0; c < 3; ++c)
+				track.translationScale(c) = (maxTranslation(c) - track.translationMin(c)) / TRANSLATION_MAX;
+
+			for (const BoneKeyframe& k : source.keyframes)
+			{
+				Keyframe packed;
+				packed.frame = k.frame;
+				EncodeRotation(k.rotation, packed.rotation);
+				for (size_t c = 0; c < 3; ++c)
+				{
+					const float range = maxTranslation(c) - track.translationMin(c);
+					const float v = range > 0.0f ? (k.translation(c) - track.translationMin(c)) / range : 0.0f;
+					packed.translation[c] = static_cast<uint16_t>(std::lround(v * TRANSLATION_MAX));
+				}
+				for (size_t c = 0; c < 4; ++c)
+				{
+					packed.curves[c * 4 + 0] = static_cast<uint8_t>(std::lround(k.curves[c].x1 * CURVE_MAX));
+					packed.curves[c * 4 + 1] = static_cast<uint8_t>(std::lround(k.curves[c].y1 * CURVE_MAX));
+					packed.curves[c * 4 + 2] = static_cast<uint8_t>(std::lround(k.curves[c].x2 * CURVE_MAX));
+					packed.curves[c * 4 + 3] = static_cast<uint8_t>(std::lround(k.curves[c].y2 * CURVE_MAX));
+				}
+				m_keyframes.push_back(packed);
+			}
+			m_tracks.push_back(std::move(track));
+		}
+	}
+
+	mth::float3 CompressedMotion::DecodeTranslation(const Track& track, const Keyframe& keyframe)
+	{
+		return mth::float3(
+			track.translationMin(0) + track.translationScale(0) * keyframe.translation[0],
+			track.translationMin(1) + track.translationScale(1) * keyframe.translation[1],
+			track.translationMin(2) + track.translationScale(2) * keyframe.translation[2]);
+	}
+
+	size_t CompressedMotion::MemorySize() const
+	{
+		size_t size = sizeof(*this) + m_tracks.capacity() * sizeof(Track) + m_keyframes.capacity() * sizeof(Keyframe);
+		for (const Track& track : m_tracks)
+			size += track.boneName.capacity();
+		return size;
+	}
+}
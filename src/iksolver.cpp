@@ -0,0 +1,145 @@
+#include "iksolver.hpp"
+
+#include <algorithm>
+
+namespace democollection
+{
+	void IkSolver::ClampRotation(mth::Affine3x4f& local, const mth::float3& minAngle, const mth::float3& maxAngle)
+	{
+		// decompose R = Rx * Ry * Rz
+		const float sy = std::clamp(local(2, 0), -1.0f, 1.0f);
+		float angles[3] = {
+			std::atan2(-local(2, 1), local(2, 2)),
+			std::asin(sy),
+			std::atan2(-local(1, 0), local(0, 0))
+		};
+		for (size_t i = 0; i < 3; ++i)
+			angles[i] = std::clamp(angles[i], std::min(minAngle(i), maxAngle(i)), std::max(minAngle(i), maxAngle(i)));
+
+		const mth::Quaternionf rotation =
+			mth::QuaternionAxisAngle(mth::float3(1.0f, 0.0f, 0.0f), angles[0]) *
+			mth::QuaternionAxisAngle(mth::float3(0.0f, 1.0f, 0.0f), angles[1]) *
+			mth::QuaternionAxisAngle(mth::float3(0.0f, 0.0f, 1.0f), angles[2]);
+		local = mth::Affine3x4f(mth::Rotation3x3(rotation), local.Translation());
+	}
+
+	IkSolver::IkSolver(const Skeleton& skeleton, const std::vector<IkChain>& chains)
+	{
+		for (const IkChain& ikChain : chains)
+		{
+			if (ikChain.links.empty() || ikChain.ikBone >= skeleton.Size() || ikChain.target >= skeleton.Size())
+				continue;
+
+			// walk up from the target to the last link, every link has to be on the way
+			const uint32_t top = ikChain.links.back().bone;
+			const size_t pathStart = m_path.size();
+			int bone = static_cast<int>(ikChain.target);
+			while (bone >= 0 && static_cast<uint32_t>(bone) != top)
+			{
+				m_path.push_back(static_cast<uint32_t>(bone));
+				bone = skeleton.Parent(bone);
+			}
+			if (bone < 0)
+			{
+				m_path.resize(pathStart);
+				continue;
+			}
+			m_path.push_back(top);
+			std::reverse(m_path.begin() + pathStart, m_path.end());
+
+			Chain chain{};
+			chain.ikBone = ikChain.ikBone;
+			chain.target = ikChain.target;
+			chain.loopCount = ikChain.loopCount;
+			chain.limitAngle = ikChain.limitAngle > 0.0f ? ikChain.limitAngle : static_cast<float>(M_PI);
+			chain.firstLink = static_cast<uint32_t>(m_links.size());
+			chain.firstPathBone = static_cast<uint32_t>(pathStart);
+			chain.pathCount = static_cast<uint32_t>(m_path.size() - pathStart);
+
+			bool valid = true;
+			for (const IkLink& ikLink : ikChain.links)
+			{
+				auto it = std::find(m_path.begin() + pathStart, m_path.end(), ikLink.bone);
+				// the target itself cannot be a link, rotating it would not move it
+				if (it == m_path.end() || ikLink.bone == ikChain.target)
+				{
+					valid = false;
+					break;
+				}
+				Link link{};
+				link.bone = ikLink.bone;
+				link.pathIndex = static_cast<uint32_t>(it - m_path.begin());
+				link.hasLimits = ikLink.hasLimits;
+				link.minAngle = ikLink.minAngle;
+				link.maxAngle = ikLink.maxAngle;
+				m_links.push_back(link);
+			}
+			if (!valid)
+			{
+				m_links.resize(chain.firstLink);
+				m_path.resize(pathStart);
+				continue;
+			}
+			chain.linkCount = static_cast<uint32_t>(m_links.size()) - chain.firstLink;
+			m_chains.push_back(chain);
+		}
+	}
+
+	void IkSolver::Solve(Skeleton& skeleton, const mth::Affine3x4f& world) const
+	{
+		for (const Chain& chain : m_chains)
+		{
+			const mth::float3 goal = skeleton.GlobalTransform(chain.ikBone).Translation();
+			mth::float3 targetPosition = skeleton.GlobalTransform(chain.target).Translation();
+			if (mth::LengthSquare(goal - targetPosition) < TOLERANCE)
+				continue;
+
+			for (uint32_t iteration = 0; iteration < chain.loopCount; ++iteration)
+			{
+				for (uint32_t l = chain.firstLink; l < chain.firstLink + chain.linkCount; ++l)
+				{
+					const Link& link = m_links[l];
+					const mth::Affine3x4f& global = skeleton.GlobalTransform(link.bone);
+					const mth::float3 linkPosition = global.Translation();
+
+					// both directions in the frame of the link, global is a rotation so its inverse is the transpose
+					const mth::float3 toTarget = targetPosition - linkPosition;
+					const mth::float3 toGoal = goal - linkPosition;
+					mth::float3 localTarget;
+					mth::float3 localGoal;
+					for (size_t x = 0; x < 3; ++x)
+					{
+						localTarget(x) = global(x, 0) * toTarget(0) + global(x, 1) * toTarget(1) + global(x, 2) * toTarget(2);
+						localGoal(x) = global(x, 0) * toGoal(0) + global(x, 1) * toGoal(1) + global(x, 2) * toGoal(2);
+					}
+					const float targetLength = mth::Length(localTarget);
+					const float goalLength = mth::Length(localGoal);
+					if (targetLength < 1e-6f || goalLength < 1e-6f)
+						continue;
+					localTarget /= targetLength;
+					localGoal /= goalLength;
+
+					const float cosAngle = mth::Dot(localTarget, localGoal);
+					const mth::float3 axis = mth::Cross(localTarget, localGoal);
+					if (cosAngle > 1.0f - 1e-7f || mth::LengthSquare(axis) < 1e-12f)
+						continue;
+					const float angle = std::min(std::acos(std::clamp(cosAngle, -1.0f, 1.0f)), chain.limitAngle);
+
+					mth::Affine3x4f& local = skeleton.LocalTransform(link.bone);
+					local = mth::Affine3x4f(local.Linear() * mth::Rotation3x3(mth::QuaternionAxisAngle(axis, angle)), local.Translation());
+					if (link.hasLimits)
+						ClampRotation(local, link.minAngle, link.maxAngle);
+
+					for (uint32_t p = link.pathIndex; p < chain.firstPathBone + chain.pathCount; ++p)
+						skeleton.UpdateGlobalTransform(m_path[p], world);
+					targetPosition = skeleton.GlobalTransform(chain.target).Translation();
+				}
+				if (mth::LengthSquare(goal - targetPosition) < TOLERANCE)
+					break;
+			}
+
+			// children of the chain that are not on the path follow the new pose
+			skeleton.UpdateGlobalTransforms(world, m_path[chain.firstPathBone]);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#include "jobsystem.hpp"
+
+namespace democollection
+{
+	void JobSystem::WorkerLoop()
+	{
+		uint64_t seenGeneration = 0;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true)
+		{
+			m_wake.wait(lock, [&]()->bool{ return m_quit || m_generation != seenGeneration; });
+			if (m_quit)
+				return;
+			seenGeneration = m_generation;
+			// woken too late, the loop has already been finished by the others
+			if (!m_job)
+				continue;
+
+			// the loop cannot finish while a worker is active, so the job stays valid
+			const std::function<void(size_t)>& job = *m_job;
+			const size_t count = m_jobCount;
+			++m_activeWorkers;
+			lock.unlock();
+			Work(job, count);
+			lock.lock();
+			if (--m_activeWorkers == 0)
+				m_done.notify_all();
+		}
+	}
+
+	void JobSystem::Work(const std::function<void(size_t)>& job, size_t count)
+	{
+		for (size_t i = m_nextJob.fetch_add(1, std::memory_order_relaxed); i < count; i = m_nextJob.fetch_add(1, std::memory_order_relaxed))
+		{
+			job(i);
+			if (m_finishedJobs.fetch_add(1, std::memory_order_acq_rel) + 1 == count)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_done.notify_all();
+			}
+		}
+	}
+
+	JobSystem::JobSystem(uint32_t threadCount)
+		: m_job{nullptr}
+		, m_jobCount{0}
+		, m_nextJob{0}
+		, m_finishedJobs{0}
+		, m_activeWorkers{0}
+		, m_generation{0}
+		, m_quit{false}
+	{
+		if (threadCount == 0)
+			threadCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+		m_workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; ++i)
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& worker : m_workers)
+			worker.join();
+	}
+
+	void JobSystem::ParallelFor(size_t count, const std::function<void(size_t)>& job)
+	{
+		if (count == 0)
+			return;
+		if (m_workers.empty() || count == 1)
+		{
+			for (size_t i = 0; i < count; ++i)
+				job(i);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_job = &job;
+			m_jobCount = count;
+			m_nextJob = 0;
+			m_finishedJobs = 0;
+			++m_generation;
+		}
+		m_wake.notify_all();
+
+		Work(job, count);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [&]()->bool{ return m_finishedJobs == count && m_activeWorkers == 0; });
+		m_job = nullptr;
+	}
+}
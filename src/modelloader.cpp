@@ -111,22 +111,27 @@ namespace democollection
 			{},
 			{}
 		};
+		// every row shares the same longitudes, so their sines and cosines are computed once
+		std::vector<float> longitudes(longitudeCount + 1);
+		std::vector<float> sinLongitudes(longitudeCount + 1);
+		std::vector<float> cosLongitudes(longitudeCount + 1);
+		for (uint32_t u = 0; u < (longitudeCount + 1); ++u)
+			longitudes[u] = static_cast<float>(u) / static_cast<float>(longitudeCount) * M_PIf * 2.0f;
+		mth::SinCos(longitudes.data(), sinLongitudes.data(), cosLongitudes.data(), longitudes.size());
+
 		arrayLocationCounter = 1;
 		for (uint32_t v = 1; v < latitudeCount - 1; ++v)
 		{
+			const float a = static_cast<float>(v) / static_cast<float>(latitudeCount - 1) * M_PIf;
+			float sina, cosa;
+			mth::SinCos(a, sina, cosa);
 			for (uint32_t u = 0; u < (longitudeCount + 1); ++u)
 			{
 				const mth::float2 scaling(
 						static_cast<float>(u) / static_cast<float>(longitudeCount),
 						static_cast<float>(v) / static_cast<float>(latitudeCount - 1)
 						);
-				const float a = scaling(1) * M_PIf;
-				const float sina = std::sin(a);
-				const float cosa = std::cos(a);
-				const float b = scaling(0) * M_PIf * 2.0f;
-				const float sinb = std::sin(b);
-				const float cosb = std::cos(b);
-				const mth::float3 normal(-1.0f * sinb * sina, cosa, cosb * sina);
+				const mth::float3 normal(-1.0f * sinLongitudes[u] * sina, cosa, cosLongitudes[u] * sina);
 				vertices[arrayLocationCounter++] = vk::Vertex{
 					center + normal * radius,
 					scaling,
@@ -183,6 +188,8 @@ namespace democollection
 	{
 		vertices.clear();
 		indices.clear();
+		skeleton.Clear();
+		ikChains.clear();
 	}
 
 	void ModelLoader::Transform(const mth::float4x4& matrix)
@@ -0,0 +1,27 @@
+#include "motion.hpp"
+
+namespace democollection
+{
+	float Bezier::Evaluate(float x) const
+	{
+		if (IsLinear() || x <= 0.0f || x >= 1.0f)
+			return x;
+
+		// x(t) is monotonic for control points in [0, 1], bisect for the t where x(t) = x
+		float lo = 0.0f;
+		float hi = 1.0f;
+		float t = x;
+		for (int i = 0; i < 16; ++i)
+		{
+			const float it = 1.0f - t;
+			const float bx = 3.0f * it * it * t * x1 + 3.0f * it * t * t * x2 + t * t * t;
+			if (bx < x)
+				lo = t;
+			else
+				hi = t;
+			t = (lo + hi) * 0.5f;
+		}
+		const float it = 1.0f - t;
+		return 3.0f * it * it * t * y1 + 3.0f * it * t * t * y2 + t * t * t;
+	}
+}
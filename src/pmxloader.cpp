@@ -78,14 +78,14 @@ namespace democollection
 		if (globals[TextEncoding] == 0)
 		{
 			std::u16string text;
-			text.resize(length / 2 + 1);
+			text.resize((length + 1) / 2);
 			infile.read(reinterpret_cast<char*>(&text[0]), length);
 			return std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>().to_bytes(text);
 		}
 		else
 		{
 			std::string text;
-			text.resize(length + 1);
+			text.resize(length);
 			infile.read(reinterpret_cast<char*>(&text[0]), length);
 			return text;
 		}
@@ -307,23 +307,53 @@ namespace democollection
 		uint32_t boneCount = 0;
 		READ(boneCount);
 		m_bones.resize(boneCount);
-		for (Bone& bone : m_bones)
-			RETURN_IF_ERROR(bone.Read(infile, m_header));
-		std::sort(m_bones.begin(), m_bones.end(), [](const Bone& lhs, const Bone& rhs)->bool{
-			return lhs.parentIndex < rhs.parentIndex;
-		});
-		
-		m_data.skeleton.resize(boneCount);
+		std::vector<int> parents(boneCount);
 		for (uint32_t i = 0; i < boneCount; ++i)
 		{
-			m_data.skeleton[i].toLocalTransform = mth::TranslationInv4x4(m_bones[i].position);
-			m_data.skeleton[i].toGlobalTransform = mth::Translation4x4(m_bones[i].position);
-			if (int parentIdx = m_bones[i].parentIndex > -1)
+			RETURN_IF_ERROR(m_bones[i].Read(infile, m_header));
+			parents[i] = m_bones[i].parentIndex;
+		}
+
+		// the skeleton needs parents before children, which the file does not guarantee
+		m_boneRemap.assign(boneCount, -1);
+		m_data.skeleton.Clear();
+		for (int boneIndex : Skeleton::ParentFirstOrder(parents))
+		{
+			const int parentIndex = m_bones[boneIndex].parentIndex;
+			const bool hasParent = parentIndex >= 0 && parentIndex < static_cast<int>(boneCount);
+			m_boneRemap[boneIndex] = m_data.skeleton.AddBone(m_bones[boneIndex].jpName, hasParent ? m_boneRemap[parentIndex] : -1, m_bones[boneIndex].position);
+		}
+
+		// vertices were loaded with the indices of the file
+		for (vk::Vertex& v : m_data.vertices)
+			for (uint32_t& boneIndex : v.boneIndices)
+				boneIndex = boneIndex < boneCount ? m_boneRemap[boneIndex] : 0;
+
+		// IK chains in skeleton order, so chains further down the hierarchy see the solved pose
+		m_data.ikChains.clear();
+		for (int boneIndex : Skeleton::ParentFirstOrder(parents))
+		{
+			const Bone& bone = m_bones[boneIndex];
+			const Bone::BoneIk& ik = bone.inverseKinematics;
+			if (!(bone.flags & Bone::BoneFlags::InverseKinematics) || ik.targetIndex < 0 || ik.targetIndex >= static_cast<int>(boneCount))
+				continue;
+			IkChain chain;
+			chain.ikBone = m_boneRemap[boneIndex];
+			chain.target = m_boneRemap[ik.targetIndex];
+			chain.loopCount = static_cast<uint32_t>(std::max(ik.loopCount, 0));
+			chain.limitAngle = ik.limitRadian;
+			for (const Bone::IkLinks& ikLink : ik.ikLinks)
 			{
-				m_data.skeleton[i].parent = &m_data.skeleton[parentIdx];
-				m_data.skeleton[i].toLocalTransform = m_data.skeleton[i].parent->toLocalTransform * m_data.skeleton[i].toLocalTransform;
-				m_data.skeleton[i].toGlobalTransform = m_data.skeleton[i].toGlobalTransform * m_data.skeleton[i].parent->toGlobalTransform;
+				if (ikLink.boneIndex < 0 || ikLink.boneIndex >= static_cast<int>(boneCount))
+					continue;
+				IkLink link{};
+				link.bone = m_boneRemap[ikLink.boneIndex];
+				link.hasLimits = ikLink.hasLimits != 0;
+				link.minAngle = ikLink.limits.minAngle;
+				link.maxAngle = ikLink.limits.maxAngle;
+				chain.links.push_back(link);
 			}
+			m_data.ikChains.push_back(std::move(chain));
 		}
 
 		return Ok;
@@ -0,0 +1,133 @@
+#include "pose.hpp"
+
+#include <cmath>
+
+namespace democollection
+{
+	Pose::Pose(size_t boneCount)
+	{
+		Resize(boneCount);
+	}
+
+	void Pose::Resize(size_t boneCount)
+	{
+		for (std::vector<float>& r : m_rotations)
+			r.resize(boneCount);
+		for (std::vector<float>& t : m_translations)
+			t.resize(boneCount);
+		SetIdentity();
+	}
+
+	void Pose::SetIdentity()
+	{
+		std::fill(m_rotations[0].begin(), m_rotations[0].end(), 0.0f);
+		std::fill(m_rotations[1].begin(), m_rotations[1].end(), 0.0f);
+		std::fill(m_rotations[2].begin(), m_rotations[2].end(), 0.0f);
+		std::fill(m_rotations[3].begin(), m_rotations[3].end(), 1.0f);
+		for (std::vector<float>& t : m_translations)
+			std::fill(t.begin(), t.end(), 0.0f);
+	}
+
+	void Pose::Apply(Skeleton& skeleton) const
+	{
+		for (size_t i = 0; i < Size(); ++i)
+			skeleton.LocalTransform(i) = mth::Affine3x4f(mth::Rotation3x3(Rotation(i)), Translation(i));
+	}
+
+	// The blend loops only touch index i of every array, so they are safe to
+	// vectorize even when 'out' aliases an input.
+	void BlendPoses(Pose& out, const Pose& a, const Pose& b, float weight, const float* mask)
+	{
+		const size_t count = out.Size();
+		const float* ax = a.Rotations(0);
+		const float* ay = a.Rotations(1);
+		const float* az = a.Rotations(2);
+		const float* aw = a.Rotations(3);
+		const float* bx = b.Rotations(0);
+		const float* by = b.Rotations(1);
+		const float* bz = b.Rotations(2);
+		const float* bw = b.Rotations(3);
+		float* rx = out.Rotations(0);
+		float* ry = out.Rotations(1);
+		float* rz = out.Rotations(2);
+		float* rw = out.Rotations(3);
+		#pragma omp simd
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float t = weight * mask[i];
+			// blend towards b or -b, whichever is on a's side
+			const float dot = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i];
+			const float tb = std::copysign(t, dot);
+			const float ta = 1.0f - t;
+			const float x = ax[i] * ta + bx[i] * tb;
+			const float y = ay[i] * ta + by[i] * tb;
+			const float z = az[i] * ta + bz[i] * tb;
+			const float w = aw[i] * ta + bw[i] * tb;
+			const float invLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+			rx[i] = x * invLength;
+			ry[i] = y * invLength;
+			rz[i] = z * invLength;
+			rw[i] = w * invLength;
+		}
+		for (size_t c = 0; c < 3; ++c)
+		{
+			const float* at = a.Translations(c);
+			const float* bt = b.Translations(c);
+			float* rt = out.Translations(c);
+			#pragma omp simd
+			for (size_t i = 0; i < count; ++i)
+				rt[i] = at[i] + (bt[i] - at[i]) * (weight * mask[i]);
+		}
+	}
+
+	void AddPoses(Pose& out, const Pose& base, const Pose& additive, float weight, const float* mask)
+	{
+		const size_t count = out.Size();
+		const float* ax = base.Rotations(0);
+		const float* ay = base.Rotations(1);
+		const float* az = base.Rotations(2);
+		const float* aw = base.Rotations(3);
+		const float* bx = additive.Rotations(0);
+		const float* by = additive.Rotations(1);
+		const float* bz = additive.Rotations(2);
+		const float* bw = additive.Rotations(3);
+		float* rx = out.Rotations(0);
+		float* ry = out.Rotations(1);
+		float* rz = out.Rotations(2);
+		float* rw = out.Rotations(3);
+		#pragma omp simd
+		for (size_t i = 0; i < count; ++i)
+		{
+			// scale the additive rotation by blending it with identity
+			const float t = weight * mask[i];
+			const float tb = std::copysign(t, bw[i]);
+			float x = bx[i] * tb;
+			float y = by[i] * tb;
+			float z = bz[i] * tb;
+			float w = bw[i] * tb + (1.0f - t);
+			const float invLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+			x *= invLength;
+			y *= invLength;
+			z *= invLength;
+			w *= invLength;
+
+			const float qx = aw[i] * x + ax[i] * w + ay[i] * z - az[i] * y;
+			const float qy = aw[i] * y - ax[i] * z + ay[i] * w + az[i] * x;
+			const float qz = aw[i] * z + ax[i] * y - ay[i] * x + az[i] * w;
+			const float qw = aw[i] * w - ax[i] * x - ay[i] * y - az[i] * z;
+			rx[i] = qx;
+			ry[i] = qy;
+			rz[i] = qz;
+			rw[i] = qw;
+		}
+		for (size_t c = 0; c < 3; ++c)
+		{
+			const float* at = base.Translations(c);
+			const float* bt = additive.Translations(c);
+			float* rt = out.Translations(c);
+			#pragma omp simd
+			for (size_t i = 0; i < count; ++i)
+				rt[i] = at[i] + bt[i] * (weight * mask[i]);
+		}
+	}
+}
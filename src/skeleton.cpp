@@ -0,0 +1,120 @@
+#include "skeleton.hpp"
+#include "common.hpp"
+
+namespace democollection
+{
+	std::vector<int> Skeleton::ParentFirstOrder(const std::vector<int>& parents)
+	{
+		enum State : uint8_t { Unvisited, Visiting, Done };
+
+		const int count = static_cast<int>(parents.size());
+		std::vector<State> states(parents.size(), Unvisited);
+		std::vector<int> order;
+		std::vector<int> chain;
+		order.reserve(parents.size());
+		for (int i = 0; i < count; ++i)
+		{
+			// collect the ancestors that are not placed yet, then place them root first
+			for (int b = i; b >= 0 && b < count && states[b] == Unvisited; b = parents[b])
+			{
+				states[b] = Visiting;
+				chain.push_back(b);
+			}
+			while (!chain.empty())
+			{
+				order.push_back(chain.back());
+				states[chain.back()] = Done;
+				chain.pop_back();
+			}
+		}
+		return order;
+	}
+
+	int Skeleton::AddBone(const std::string& name, int parent, const mth::float3& bindPosition)
+	{
+		ThrowIfFalse(parent < static_cast<int>(Size()), "Parent bones have to be added before their children");
+
+		m_names.push_back(name);
+		m_parents.push_back(parent);
+		m_bindPositions.push_back(bindPosition);
+		m_bindOffsets.push_back(parent < 0 ? bindPosition : bindPosition - m_bindPositions[parent]);
+		m_localTransforms.emplace_back();
+		m_globalTransforms.push_back(mth::Translation3x4(bindPosition));
+		return static_cast<int>(Size()) - 1;
+	}
+
+	int Skeleton::FindBone(const std::string& name) const
+	{
+		for (size_t i = 0; i < m_names.size(); ++i)
+			if (m_names[i] == name)
+				return static_cast<int>(i);
+		return -1;
+	}
+
+	void Skeleton::Clear()
+	{
+		m_names.clear();
+		m_parents.clear();
+		m_bindPositions.clear();
+		m_bindOffsets.clear();
+		m_localTransforms.clear();
+		m_globalTransforms.clear();
+	}
+
+	void Skeleton::ResetPose()
+	{
+		for (mth::Affine3x4f& t : m_localTransforms)
+			t = mth::Affine3x4f();
+	}
+
+	void Skeleton::UpdateGlobalTransforms(const mth::Affine3x4f& world, size_t firstBone)
+	{
+		for (size_t i = firstBone; i < Size(); ++i)
+			UpdateGlobalTransform(i, world);
+	}
+
+	void Skeleton::UpdateGlobalTransform(size_t bone, const mth::Affine3x4f& world)
+	{
+		mth::Affine3x4f node = m_localTransforms[bone];
+		for (size_t y = 0; y < 3; ++y)
+			node(3, y) += m_bindOffsets[bone](y);
+		if (m_parents[bone] < 0)
+			mth::Multiply(m_globalTransforms[bone], world, node);
+		else
+			mth::Multiply(m_globalTransforms[bone], m_globalTransforms[m_parents[bone]], node);
+	}
+
+	void Skeleton::WriteSkinningMatrices(mth::Affine3x4f* out) const
+	{
+		for (size_t i = 0; i < Size(); ++i)
+		{
+			const mth::Affine3x4f& g = m_globalTransforms[i];
+			const mth::float3& b = m_bindPositions[i];
+			for (size_t y = 0; y < 3; ++y)
+			{
+				out[i](0, y) = g(0, y);
+				out[i](1, y) = g(1, y);
+				out[i](2, y) = g(2, y);
+				out[i](3, y) = g(3, y) - (g(0, y) * b(0) + g(1, y) * b(1) + g(2, y) * b(2));
+			}
+		}
+	}
+
+	void Skeleton::WriteSkinningDualQuaternions(mth::float4* out) const
+	{
+		for (size_t i = 0; i < Size(); ++i)
+		{
+			const mth::Affine3x4f& g = m_globalTransforms[i];
+			const mth::float3& b = m_bindPositions[i];
+			const mth::Quaternionf real = mth::ToQuaternion(g.Linear());
+			mth::Quaternionf translation;
+			translation.x = g(3, 0) - (g(0, 0) * b(0) + g(1, 0) * b(1) + g(2, 0) * b(2));
+			translation.y = g(3, 1) - (g(0, 1) * b(0) + g(1, 1) * b(1) + g(2, 1) * b(2));
+			translation.z = g(3, 2) - (g(0, 2) * b(0) + g(1, 2) * b(1) + g(2, 2) * b(2));
+			translation.w = 0.0f;
+			const mth::Quaternionf dual = translation * real * 0.5f;
+			out[2 * i] = mth::float4(real.x, real.y, real.z, real.w);
+			out[2 * i + 1] = mth::float4(dual.x, dual.y, dual.z, dual.w);
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#include "vk/deletionqueue.hpp"
+
+namespace democollection::vk
+{
+	DeletionQueue::DeletionQueue()
+		: m_frame{0}
+	{}
+
+	void DeletionQueue::Push(std::function<void()> release)
+	{
+		m_entries.push_back(Entry{m_frame, std::move(release)});
+	}
+
+	void DeletionQueue::NextFrame()
+	{
+		++m_frame;
+		// uploads recorded during frame F are submitted ahead of frame F + 1, so that one has to complete too
+		while (!m_entries.empty() && m_entries.front().frame + MAX_FRAMES_IN_FLIGHT + 1 <= m_frame)
+		{
+			m_entries.front().release();
+			m_entries.pop_front();
+		}
+	}
+
+	void DeletionQueue::ReleaseAll()
+	{
+		while (!m_entries.empty())
+		{
+			m_entries.front().release();
+			m_entries.pop_front();
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#include "vk/geometryarena.hpp"
+
+namespace democollection::vk
+{
+	// Tlsf rounds requests up to its size classes, by up to an eighth; with a quarter
+	// on top the requested capacity always fits
+	static uint32_t PaddedCapacity(uint32_t capacity)
+	{
+		return capacity + capacity / 4 + 16;
+	}
+
+	GeometryArena::GeometryArena(const Vulkan& vulkan, uint32_t vertexCapacity, uint32_t indexCapacity, uint32_t skinnedVertexCapacity)
+		: m_vertices(vulkan, Buffer::Type::Vertex, sizeof(Vertex) * PaddedCapacity(vertexCapacity))
+		, m_indices(vulkan, Buffer::Type::Index, sizeof(uint32_t) * PaddedCapacity(indexCapacity))
+		, m_skinnedVertices(vulkan, PerFrameBuffer::Type::Vertex, sizeof(SkinnedVertex) * PaddedCapacity(skinnedVertexCapacity))
+		, m_vertexRanges(PaddedCapacity(vertexCapacity))
+		, m_indexRanges(PaddedCapacity(indexCapacity))
+		, m_skinnedVertexRanges(PaddedCapacity(skinnedVertexCapacity))
+	{}
+
+	void GeometryArena::Allocate(uint32_t vertexCount, uint32_t indexCount, Tlsf::Handle ranges[2], uint32_t& firstVertex, uint32_t& firstIndex)
+	{
+		VkDeviceSize vertexOffset, indexOffset;
+		ranges[0] = m_vertexRanges.Allocate(vertexCount, 1, vertexOffset);
+		ThrowIfFalse(ranges[0] != Tlsf::NONE, "Geometry arena is out of vertices");
+		ranges[1] = m_indexRanges.Allocate(indexCount, 1, indexOffset);
+		if (ranges[1] == Tlsf::NONE)
+		{
+			m_vertexRanges.Free(ranges[0]);
+			Throw("Geometry arena is out of indices");
+		}
+		firstVertex = static_cast<uint32_t>(vertexOffset);
+		firstIndex = static_cast<uint32_t>(indexOffset);
+	}
+
+	void GeometryArena::Free(const Tlsf::Handle ranges[2])
+	{
+		m_vertexRanges.Free(ranges[0]);
+		m_indexRanges.Free(ranges[1]);
+	}
+
+	Tlsf::Handle GeometryArena::AllocateSkinned(uint32_t vertexCount, uint32_t& firstVertex)
+	{
+		VkDeviceSize offset;
+		const Tlsf::Handle range = m_skinnedVertexRanges.Allocate(vertexCount, 1, offset);
+		ThrowIfFalse(range != Tlsf::NONE, "Geometry arena is out of skinned vertices");
+		firstVertex = static_cast<uint32_t>(offset);
+		return range;
+	}
+
+	void GeometryArena::FreeSkinned(Tlsf::Handle range)
+	{
+		m_skinnedVertexRanges.Free(range);
+	}
+
+	void GeometryArena::Bind(VkCommandBuffer commandBuffer, uint32_t frame) const
+	{
+		// the source vertices are only read by the skinning shader
+		const VkBuffer vertexBuffer = m_skinnedVertices.Get(frame);
+		const VkDeviceSize offset = 0;
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+		vkCmdBindIndexBuffer(commandBuffer, m_indices.Get(), 0, VK_INDEX_TYPE_UINT32);
+	}
+}
@@ -0,0 +1,28 @@
+#include "vk/materialarena.hpp"
+#include "vk/transferbatch.hpp"
+
+namespace democollection::vk
+{
+	MaterialArena::MaterialArena(const Vulkan& vulkan, uint32_t capacity)
+		: m_vulkan{vulkan}
+		, m_buffer(vulkan, vk::Buffer::Type::DeviceStorage, sizeof(ModelBufferFs) * std::max(capacity, 1u))
+		, m_capacity{std::max(capacity, 1u)}
+		, m_used{0}
+	{}
+
+	uint32_t MaterialArena::Add(const std::vector<MaterialData>& materials)
+	{
+		const uint32_t count = static_cast<uint32_t>(materials.size());
+		ThrowIfFalse(count <= m_capacity - m_used, "Material arena is full");
+		const uint32_t first = m_used;
+		m_used += count;
+		if (count)
+		{
+			std::vector<ModelBufferFs> data(count);
+			for (uint32_t i = 0; i < count; ++i)
+				data[i] = materials[i].data;
+			m_vulkan.Transfers().CopyToBuffer(m_buffer.Get(), sizeof(ModelBufferFs) * first, data.data(), sizeof(ModelBufferFs) * count);
+		}
+		return first;
+	}
+}
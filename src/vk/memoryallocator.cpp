@@ -0,0 +1,292 @@
+#include "vk/memoryallocator.hpp"
+
+#include <algorithm>
+
+namespace democollection::vk
+{
+	VkDeviceMemory MemoryAllocator::AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, void** mapped)
+	{
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryType;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		const VkResult result = vkAllocateMemory(m_device, &allocInfo, m_callbacks, &memory);
+		if (VK_ERROR_OUT_OF_DEVICE_MEMORY == result)
+			return VK_NULL_HANDLE;
+		ThrowIfFailed(result);
+
+		*mapped = nullptr;
+		if (m_properties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			ThrowIfFailed(vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, mapped));
+
+		m_heapReserved[m_properties.memoryTypes[memoryType].heapIndex] += size;
+		m_reservedBytes += size;
+		m_peakReservedBytes = std::max(m_peakReservedBytes, m_reservedBytes);
+		return memory;
+	}
+
+	void MemoryAllocator::FreeDeviceMemory(uint32_t memoryType, VkDeviceMemory memory, VkDeviceSize size)
+	{
+		// freeing implicitly unmaps
+		vkFreeMemory(m_device, memory, m_callbacks);
+		m_heapReserved[m_properties.memoryTypes[memoryType].heapIndex] -= size;
+		m_reservedBytes -= size;
+	}
+
+	MemoryAllocator::MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* callbacks, bool memoryBudget)
+		: m_device{device}
+		, m_physicalDevice{physicalDevice}
+		, m_callbacks{callbacks}
+		, m_properties{}
+		, m_memoryBudget{memoryBudget}
+		, m_separateImages{}
+		, m_dedicated{}
+		, m_categories{}
+		, m_reservedBytes{0}
+		, m_usedBytes{0}
+		, m_peakReservedBytes{0}
+		, m_peakUsedBytes{0}
+	{
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_properties);
+		m_heapReserved.resize(m_properties.memoryHeapCount);
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		m_separateImages = properties.limits.bufferImageGranularity > 1;
+
+		m_pools.resize(m_properties.memoryTypeCount * 2);
+		for (uint32_t i = 0; i < m_properties.memoryTypeCount; ++i)
+		{
+			// small heaps, like the host visible window into video memory, get smaller blocks
+			const VkDeviceSize heapSize = m_properties.memoryHeaps[m_properties.memoryTypes[i].heapIndex].size;
+			for (uint32_t kind = 0; kind < 2; ++kind)
+			{
+				Pool& pool = m_pools[i * 2 + kind];
+				pool.memoryType = i;
+				pool.blockSize = std::min(DEFAULT_BLOCK_SIZE, heapSize / 8);
+			}
+		}
+	}
+
+	MemoryAllocator::~MemoryAllocator()
+	{
+		for (Pool& pool : m_pools)
+			for (std::unique_ptr<Block>& block : pool.blocks)
+				if (block)
+					FreeDeviceMemory(pool.memoryType, block->memory, block->ranges.Size());
+	}
+
+	uint32_t MemoryAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+	{
+		for (uint32_t i = 0; i < m_properties.memoryTypeCount; ++i)
+			if ((typeFilter & (1 << i)) && (m_properties.memoryTypes[i].propertyFlags & properties) == properties)
+				return i;
+		Throw("failed to find suitable memory type");
+	}
+
+	bool MemoryAllocator::HasHostVisibleDeviceLocal(uint32_t typeFilter) const
+	{
+		const VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		// the first match is the type FindMemoryType would pick
+		for (uint32_t i = 0; i < m_properties.memoryTypeCount; ++i)
+			if ((typeFilter & (1 << i)) && (m_properties.memoryTypes[i].propertyFlags & properties) == properties)
+				return m_properties.memoryHeaps[m_properties.memoryTypes[i].heapIndex].size > BAR_WINDOW_SIZE;
+		return false;
+	}
+
+	void MemoryAllocator::AddUsed(MemoryCategory category, VkDeviceSize size)
+	{
+		CategoryStats& categoryStats = m_categories[static_cast<uint32_t>(category)];
+		++categoryStats.allocationCount;
+		categoryStats.usedBytes += size;
+		categoryStats.peakUsedBytes = std::max(categoryStats.peakUsedBytes, categoryStats.usedBytes);
+		m_usedBytes += size;
+		m_peakUsedBytes = std::max(m_peakUsedBytes, m_usedBytes);
+	}
+
+	Allocation MemoryAllocator::TryAllocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, Kind kind, MemoryCategory category)
+	{
+		const uint32_t memoryType = FindMemoryType(requirements.memoryTypeBits, properties);
+		Allocation allocation;
+		allocation.pool = memoryType * 2 + (m_separateImages && kind == Kind::OptimalImage ? 1 : 0);
+		allocation.size = requirements.size;
+		allocation.category = category;
+		Pool& pool = m_pools[allocation.pool];
+
+		if (requirements.size > pool.blockSize / 2)
+		{
+			allocation.memory = AllocateDeviceMemory(memoryType, requirements.size, &allocation.mapped);
+			if (!allocation)
+				return Allocation{};
+			++m_dedicated.dedicatedCount;
+			m_dedicated.reservedBytes += requirements.size;
+			AddUsed(category, requirements.size);
+			return allocation;
+		}
+
+		uint32_t freeSlot = UINT32_MAX;
+		for (uint32_t i = 0; i < pool.blocks.size(); ++i)
+		{
+			Block* block = pool.blocks[i].get();
+			if (!block)
+			{
+				freeSlot = i;
+				continue;
+			}
+			allocation.range = block->ranges.Allocate(requirements.size, requirements.alignment, allocation.offset);
+			if (allocation.range != Tlsf::NONE)
+			{
+				allocation.memory = block->memory;
+				allocation.block = i;
+				break;
+			}
+		}
+		if (!allocation.memory)
+		{
+			std::unique_ptr<Block> block = std::make_unique<Block>();
+			block->memory = AllocateDeviceMemory(memoryType, pool.blockSize, &block->mapped);
+			if (!block->memory)
+				return Allocation{};
+			block->ranges = Tlsf(pool.blockSize);
+			allocation.range = block->ranges.Allocate(requirements.size, requirements.alignment, allocation.offset);
+			ThrowIfFalse(allocation.range != Tlsf::NONE, "The allocation does not fit into an empty block");
+			allocation.memory = block->memory;
+			if (freeSlot == UINT32_MAX)
+			{
+				allocation.block = static_cast<uint32_t>(pool.blocks.size());
+				pool.blocks.push_back(std::move(block));
+			}
+			else
+			{
+				allocation.block = freeSlot;
+				pool.blocks[freeSlot] = std::move(block);
+			}
+		}
+
+		void* blockData = pool.blocks[allocation.block]->mapped;
+		if (blockData)
+			allocation.mapped = static_cast<uint8_t*>(blockData) + allocation.offset;
+		AddUsed(category, requirements.size);
+		return allocation;
+	}
+
+	Allocation MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, Kind kind, MemoryCategory category)
+	{
+		Allocation allocation = TryAllocate(requirements, properties, kind, category);
+		ThrowIfFalse(static_cast<bool>(allocation), "Out of device memory");
+		return allocation;
+	}
+
+	Allocation MemoryAllocator::AllocateImage(VkImage image, VkMemoryPropertyFlags properties, MemoryCategory category)
+	{
+		VkMemoryRequirements memRequirements{};
+		vkGetImageMemoryRequirements(m_device, image, &memRequirements);
+		Allocation allocation = Allocate(memRequirements, properties, Kind::OptimalImage, category);
+		ThrowIfFailed(vkBindImageMemory(m_device, image, allocation.memory, allocation.offset));
+		return allocation;
+	}
+
+	void MemoryAllocator::Free(Allocation& allocation)
+	{
+		if (!allocation)
+			return;
+		CategoryStats& categoryStats = m_categories[static_cast<uint32_t>(allocation.category)];
+		--categoryStats.allocationCount;
+		categoryStats.usedBytes -= allocation.size;
+		m_usedBytes -= allocation.size;
+
+		if (allocation.range == Tlsf::NONE)
+		{
+			FreeDeviceMemory(m_pools[allocation.pool].memoryType, allocation.memory, allocation.size);
+			--m_dedicated.dedicatedCount;
+			m_dedicated.reservedBytes -= allocation.size;
+		}
+		else
+		{
+			Pool& pool = m_pools[allocation.pool];
+			std::unique_ptr<Block>& block = pool.blocks[allocation.block];
+			block->ranges.Free(allocation.range);
+			// keep one block around so a pool that empties and fills again does not allocate every time
+			const bool lastBlock = std::count_if(pool.blocks.begin(), pool.blocks.end(),
+					[](const std::unique_ptr<Block>& b)->bool{ return b != nullptr; }) == 1;
+			if (block->ranges.Empty() && !lastBlock)
+			{
+				FreeDeviceMemory(pool.memoryType, block->memory, block->ranges.Size());
+				block.reset();
+			}
+		}
+		allocation = Allocation{};
+	}
+
+	MemoryAllocator::Stats MemoryAllocator::GetStats() const
+	{
+		Stats stats = m_dedicated;
+		stats.allocationCount = m_dedicated.dedicatedCount;
+		stats.usedBytes = m_dedicated.reservedBytes;
+		for (const Pool& pool : m_pools)
+		{
+			for (const std::unique_ptr<Block>& block : pool.blocks)
+			{
+				if (!block)
+					continue;
+				++stats.blockCount;
+				stats.allocationCount += block->ranges.AllocationCount();
+				stats.reservedBytes += block->ranges.Size();
+				stats.usedBytes += block->ranges.Used();
+			}
+		}
+		stats.peakReservedBytes = m_peakReservedBytes;
+		stats.peakUsedBytes = m_peakUsedBytes;
+		return stats;
+	}
+
+	std::vector<MemoryAllocator::HeapBudget> MemoryAllocator::GetHeapBudgets() const
+	{
+		std::vector<HeapBudget> budgets(m_properties.memoryHeapCount);
+		for (uint32_t i = 0; i < m_properties.memoryHeapCount; ++i)
+		{
+			budgets[i].size = m_properties.memoryHeaps[i].size;
+			budgets[i].budget = m_properties.memoryHeaps[i].size;
+			budgets[i].usage = m_heapReserved[i];
+			budgets[i].reservedBytes = m_heapReserved[i];
+			budgets[i].deviceLocal = m_properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+		}
+
+		if (m_memoryBudget)
+		{
+			VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+			budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+			VkPhysicalDeviceMemoryProperties2 properties{};
+			properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+			properties.pNext = &budgetProperties;
+			vkGetPhysicalDeviceMemoryProperties2(m_physicalDevice, &properties);
+			for (uint32_t i = 0; i < m_properties.memoryHeapCount; ++i)
+			{
+				budgets[i].budget = budgetProperties.heapBudget[i];
+				budgets[i].usage = budgetProperties.heapUsage[i];
+			}
+		}
+		return budgets;
+	}
+
+	const char* MemoryAllocator::CategoryName(MemoryCategory category)
+	{
+		switch (category)
+		{
+		case MemoryCategory::Mesh:
+			return "mesh";
+		case MemoryCategory::Texture:
+			return "texture";
+		case MemoryCategory::Uniform:
+			return "uniform";
+		case MemoryCategory::Storage:
+			return "storage";
+		case MemoryCategory::Staging:
+			return "staging";
+		case MemoryCategory::Attachment:
+			return "attachment";
+		default:
+			return "unknown";
+		}
+	}
+}
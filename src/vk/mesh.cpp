@@ -1,32 +1,56 @@
 #include "vk/mesh.hpp"
-
+#include "vk/transferbatch.hpp"
+#include "vk/deletionqueue.hpp"
 
 namespace democollection::vk
 {
-	Mesh::Mesh(const Vulkan& vulkan, const Vertex vertices[], uint32_t vertexCount, const uint32_t indices[], uint32_t indexCount)
+	Mesh::Mesh(const Vulkan& vulkan, GeometryArena& arena, const Vertex vertices[], uint32_t vertexCount, const uint32_t indices[], uint32_t indexCount)
+		: m_vulkan{vulkan}
+		, m_arena{arena}
+		, m_ranges{}
+		, m_firstVertex{}
+		, m_vertexCount{vertexCount}
+		, m_firstIndex{}
+		, m_indexCount{indexCount}
+	{
+		m_arena.Allocate(vertexCount, indexCount, m_ranges, m_firstVertex, m_firstIndex);
+		vulkan.Transfers().CopyToBuffer(m_arena.Vertices().Get(), sizeof(Vertex) * m_firstVertex, vertices, sizeof(Vertex) * vertexCount);
+		vulkan.Transfers().CopyToBuffer(m_arena.Indices().Get(), sizeof(uint32_t) * m_firstIndex, indices, sizeof(uint32_t) * indexCount);
+	}
+
+	Mesh::~Mesh()
+	{
+		// the ranges are reused once no frame in flight draws them
+		m_vulkan.Deletions().Push([&arena = m_arena, ranges = std::to_array(m_ranges)]() {
+			arena.Free(ranges.data());
+		});
+	}
+
+	MeshInstance::MeshInstance(const Vulkan& vulkan, GeometryArena& arena, std::shared_ptr<const Mesh> mesh)
 		: m_vulkan{vulkan}
-		,m_vertexBuffer(vulkan, Buffer::Type::Vertex, sizeof(Vertex) * vertexCount)
-		, m_indexBuffer(vulkan, Buffer::Type::Index, sizeof(uint32_t) * indexCount)
+		, m_arena{arena}
+		, m_mesh{std::move(mesh)}
+		, m_firstSkinnedVertex{}
 	{
-		m_vertexBuffer.CopyDataFrom(Buffer(vulkan, Buffer::Type::Staging, sizeof(Vertex) * vertexCount, vertices));
-		m_indexBuffer.CopyDataFrom(Buffer(vulkan, Buffer::Type::Staging, sizeof(uint32_t) * indexCount, indices));
+		m_skinnedRange = m_arena.AllocateSkinned(m_mesh->VertexCount(), m_firstSkinnedVertex);
 	}
 
-	void Mesh::Bind() const
+	MeshInstance::~MeshInstance()
 	{
-		VkBuffer vertexBuffer = m_vertexBuffer.Get();
-		VkDeviceSize offset = 0;
-		vkCmdBindVertexBuffers(m_vulkan.CommandBuffer(), 0, 1, &vertexBuffer, &offset);
-		vkCmdBindIndexBuffer(m_vulkan.CommandBuffer(), m_indexBuffer.Get(), 0, VK_INDEX_TYPE_UINT32);
+		// frames in flight may still skin into the range
+		m_vulkan.Deletions().Push([&arena = m_arena, range = m_skinnedRange]() {
+			arena.FreeSkinned(range);
+		});
 	}
 
-	void Mesh::Draw() const
+	void MeshInstance::Draw() const
 	{
-		Draw(0, m_indexBuffer.Size() / sizeof(uint32_t));
+		Draw(0, m_mesh->IndexCount());
 	}
 
-	void Mesh::Draw(uint32_t first, uint32_t count) const
+	void MeshInstance::Draw(uint32_t first, uint32_t count) const
 	{
-		vkCmdDrawIndexed(m_vulkan.CommandBuffer(), count, 1, first, 0, 0);
+		// indices stay relative to the mesh, vertexOffset moves them to the instance's skinned vertices
+		vkCmdDrawIndexed(m_vulkan.CommandBuffer(), count, 1, m_mesh->FirstIndex() + first, static_cast<int32_t>(m_firstSkinnedVertex), 0);
 	}
 }
@@ -3,50 +3,121 @@
 
 namespace democollection::vk
 {
-	mth::float4x4& Model::BoneTransforms(int index) const
-	{
-		return m_vsBuffer->Data<mth::float4x4>()[index];
-	}
-
 	Model::Model(Graphics& graphics,
 			const UniformBuffer& sceneBufferVs,
 			const UniformBuffer& sceneBufferFs,
+			PaletteArena& paletteArena,
+			GeometryArena& geometryArena,
+			std::shared_ptr<const Mesh> mesh,
+			const MaterialArena& materialArena,
+			uint32_t firstMaterial,
 			const ModelLoader& modelLoader)
 		: m_graphics{graphics}
+		, m_paletteArena{paletteArena}
+		, m_skinningMode{SkinningMode::DualQuaternion}
+		, m_posed{false}
 	{
-		m_vsBuffer = std::make_unique<UniformBuffer>(graphics, sizeof(mth::float4x4) * modelLoader.Skeleton().size());
+		// a model without bones still gets one, its vertices all reference bone 0
+		m_paletteOffset = paletteArena.Allocate(static_cast<uint32_t>(std::max<size_t>(modelLoader.Skeleton().Size(), 1)));
+		m_drawnPaletteOffset = m_paletteOffset;
 
-		m_mesh = std::make_unique<Mesh>(graphics,
-				modelLoader.Vertices().data(), static_cast<uint32_t>(modelLoader.Vertices().size()),
-				modelLoader.Indices().data(), static_cast<uint32_t>(modelLoader.Indices().size()));
+		m_mesh = std::make_unique<MeshInstance>(graphics, geometryArena, std::move(mesh));
 
 		const std::vector<MaterialData>& materials = modelLoader.Materials();
-		m_descriptorPool = std::make_unique<DescriptorPool>(graphics, materials.size());
+		m_descriptorPool = std::make_unique<DescriptorPool>(graphics, materials.size() + 1);
+		m_skinningDescriptorSet = std::make_unique<SkinningDescriptorSet>(graphics, *m_descriptorPool, paletteArena.Buffer(), geometryArena.Vertices(), geometryArena.SkinnedVertices());
 		m_parts.resize(materials.size());
 		for (size_t i = 0; i < materials.size(); ++i)
 		{
 			m_parts[i].firstIndex = materials[i].firstIndex;
 			m_parts[i].indexCount = materials[i].indexCount;
-			m_parts[i].fsBuffer = std::make_unique<UniformBuffer>(graphics, sizeof(ModelBufferFs));
+			m_parts[i].material = firstMaterial + static_cast<uint32_t>(i);
 			m_parts[i].texture = graphics.LoadTexture(materials[i].textureName);
-			m_parts[i].descriptorSet = std::make_unique<DescriptorSet>(graphics, *m_descriptorPool, sceneBufferVs, *m_vsBuffer, sceneBufferFs, *m_parts[i].fsBuffer, *m_parts[i].texture);
+			m_parts[i].descriptorSet = std::make_unique<DescriptorSet>(graphics, *m_descriptorPool, sceneBufferVs, sceneBufferFs, materialArena.Buffer(), *m_parts[i].texture);
 		}
 
 		m_skeleton = modelLoader.Skeleton();
+		m_ikSolver = IkSolver(m_skeleton, modelLoader.IkChains());
+		m_blender = std::make_unique<AnimationBlender>(m_skeleton);
+		m_rigKey = PoseCache::RigKey(m_skeleton, modelLoader.IkChains());
+	}
+
+	void Model::SetMotion(std::shared_ptr<const CompressedMotion> motion)
+	{
+		m_skeleton.ResetPose();
+		m_blender->Play(0, std::move(motion), 0.0f);
+	}
+
+	void Model::SharePose(PoseCache& cache, float time)
+	{
+		m_drawnPaletteOffset = m_paletteOffset;
+		m_poseKey.reset();
+		float frame;
+		const CompressedMotion* motion = m_blender->SingleClip(time, frame);
+		if (!motion)
+			return;
+		m_poseKey = PoseCache::Key{motion, m_rigKey, cache.Quantize(frame), m_skinningMode};
+		m_drawnPaletteOffset = cache.Acquire(*m_poseKey, m_paletteOffset);
+	}
+
+	void Model::Animate(float time)
+	{
+		// the pose is evaluated in model space, the skinning shader applies the world transform
+		if (m_poseKey)
+			m_blender->EvaluateFrame(m_poseKey->frame, m_skeleton);
+		else
+			m_blender->Evaluate(time, m_skeleton);
+		m_skeleton.UpdateGlobalTransforms();
+		m_ikSolver.Solve(m_skeleton);
+		m_posed = true;
+	}
+
+	void Model::WritePalette() const
+	{
+		mth::float4* palette = m_paletteArena.Data(m_paletteOffset);
+		if (m_skeleton.Empty())
+		{
+			if (m_skinningMode == SkinningMode::DualQuaternion)
+			{
+				palette[0] = mth::float4(0.0f, 0.0f, 0.0f, 1.0f);
+				palette[1] = mth::float4(0.0f);
+			}
+			else
+			{
+				*reinterpret_cast<mth::Affine3x4f*>(palette) = mth::Affine3x4f();
+			}
+		}
+		else if (m_skinningMode == SkinningMode::DualQuaternion)
+		{
+			m_skeleton.WriteSkinningDualQuaternions(palette);
+		}
+		else
+		{
+			m_skeleton.WriteSkinningMatrices(reinterpret_cast<mth::Affine3x4f*>(palette));
+		}
 	}
 
-	void Model::Update()
+	void Model::Skin() const
 	{
-		for (size_t i = 0; i < m_skeleton.size(); ++i)
-			BoneTransforms(i) = m_skeleton[i].toGlobalTransform * (m_skeleton[i].boneTransform * m_skeleton[i].toLocalTransform);
+		SkinningPushConstants constants{};
+		constants.vertexCount = m_mesh->GetMesh().VertexCount();
+		constants.paletteOffset = m_drawnPaletteOffset;
+		constants.firstVertex = m_mesh->GetMesh().FirstVertex();
+		constants.firstSkinnedVertex = m_mesh->FirstSkinnedVertex();
+		constants.world = m_world;
+		vkCmdBindPipeline(m_graphics.CommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, m_graphics.SkinningPipeline(m_skinningMode));
+		m_skinningDescriptorSet->Bind();
+		vkCmdPushConstants(m_graphics.CommandBuffer(), m_graphics.SkinningPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+		vkCmdDispatch(m_graphics.CommandBuffer(), (constants.vertexCount + SKINNING_GROUP_SIZE - 1) / SKINNING_GROUP_SIZE, 1, 1);
 	}
 
 	void Model::Render() const
 	{
-		m_mesh->Bind();
 		for (const ModelPart& part : m_parts)
 		{
 			part.descriptorSet->Bind();
+			const MaterialPushConstants constants{part.material};
+			vkCmdPushConstants(m_graphics.CommandBuffer(), m_graphics.PipelineLayout(), VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants), &constants);
 			m_mesh->Draw(part.firstIndex, part.indexCount);
 		}
 	}
@@ -0,0 +1,18 @@
+#include "vk/palettearena.hpp"
+
+namespace democollection::vk
+{
+	PaletteArena::PaletteArena(const Vulkan& vulkan, uint32_t boneCapacity)
+		: m_buffer(vulkan, sizeof(mth::float4) * BONE_SIZE * std::max(boneCapacity, 1u))
+		, m_capacity{BONE_SIZE * std::max(boneCapacity, 1u)}
+		, m_used{0}
+	{}
+
+	uint32_t PaletteArena::Allocate(uint32_t boneCount)
+	{
+		ThrowIfFalse(boneCount * BONE_SIZE <= m_capacity - m_used, "Bone palette arena is full");
+		const uint32_t offset = m_used;
+		m_used += boneCount * BONE_SIZE;
+		return offset;
+	}
+}
@@ -17,7 +17,15 @@ namespace democollection::vk
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME
 	};
 
-	bool PhysicalDevice::CheckDeviceExtensionSupport() const
+	bool PhysicalDevice::IsExtensionSupported(const std::vector<VkExtensionProperties>& availableExtensions, const char* extension) const
+	{
+		for (const VkExtensionProperties& ext : availableExtensions)
+			if (0 == strcmp(extension, ext.extensionName))
+				return true;
+		return false;
+	}
+
+	bool PhysicalDevice::CheckDeviceExtensionSupport()
 	{
 		uint32_t extensionCount = 0;
 		vkEnumerateDeviceExtensionProperties(m_device, nullptr, &extensionCount, nullptr);
@@ -25,20 +33,11 @@ namespace democollection::vk
 		vkEnumerateDeviceExtensionProperties(m_device, nullptr, &extensionCount, availableExtensions.data());
 
 		for (const char* devExtension : PhysicalDevice::sDeviceExtensions)
-		{
-			bool extensionFound = false;
-			for (const VkExtensionProperties& ext : availableExtensions)
-			{
-				if (0 == strcmp(devExtension, ext.extensionName))
-				{
-					extensionFound = true;
-					break;
-				}
-			}
-			if (!extensionFound)
+			if (!IsExtensionSupported(availableExtensions, devExtension))
 				return false;
-		}
 
+		m_memoryBudget = m_properties.apiVersion >= VK_API_VERSION_1_1 &&
+				IsExtensionSupported(availableExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 		return true;
 	}
 
@@ -49,6 +48,12 @@ namespace democollection::vk
 		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
 		vkGetPhysicalDeviceQueueFamilyProperties(m_device, &queueFamilyCount, queueFamilies.data());
 
+		// copy engines show up as families with nothing but transfer, they work beside rendering
+		uint32_t transferQueueIndex = UINT32_MAX;
+		for (uint32_t i = 0; i < queueFamilyCount && UINT32_MAX == transferQueueIndex; ++i)
+			if ((queueFamilies[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT)) == VK_QUEUE_TRANSFER_BIT)
+				transferQueueIndex = i;
+
 		m_graphicsQueueIndex = UINT32_MAX;
 		m_presentQueueIndex = UINT32_MAX;
 		for (uint32_t i = 0; i < queueFamilyCount; ++i)
@@ -60,6 +65,7 @@ namespace democollection::vk
 			{
 				m_graphicsQueueIndex = i;
 				m_presentQueueIndex = i;
+				m_transferQueueIndex = UINT32_MAX == transferQueueIndex ? i : transferQueueIndex;
 				return COMMON_GFX_PRESENT_QUEUE_SCORE;
 			}
 			if (m_graphicsQueueIndex != UINT32_MAX && gfxQueueSupport)
@@ -68,7 +74,10 @@ namespace democollection::vk
 				m_presentQueueIndex = i;
 		}
 		if (UINT32_MAX != m_graphicsQueueIndex && UINT32_MAX != m_presentQueueIndex)
+		{
+			m_transferQueueIndex = UINT32_MAX == transferQueueIndex ? m_graphicsQueueIndex : transferQueueIndex;
 			return ACCEPTABLE_SCORE;
+		}
 
 		return 0;
 	}
@@ -195,11 +204,13 @@ namespace democollection::vk
 		: m_device{device}
 		, m_graphicsQueueIndex{}
 		, m_presentQueueIndex{}
+		, m_transferQueueIndex{}
 		, m_surfaceCapabilities{}
 		, m_surfaceFormat{}
 		, m_depthFormat{}
 		, m_presentMode{}
 		, m_msaaSampleCount{}
+		, m_memoryBudget{false}
 	{}
 
 	uint32_t PhysicalDevice::ScoreDevice(VkSurfaceKHR surface)
@@ -0,0 +1,84 @@
+#include "vk/posecache.hpp"
+
+#include <cmath>
+
+namespace democollection::vk
+{
+	// FNV-1a
+	static void HashBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+			hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+	}
+
+	template <typename T>
+	static void HashValue(uint64_t& hash, const T& value)
+	{
+		HashBytes(hash, &value, sizeof(value));
+	}
+
+	size_t PoseCache::KeyHash::operator()(const Key& key) const
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		HashValue(hash, key.motion);
+		HashValue(hash, key.rig);
+		HashValue(hash, key.frame + 0.0f);	// -0 and 0 compare equal, so they have to hash equal
+		HashValue(hash, key.mode);
+		return static_cast<size_t>(hash);
+	}
+
+	PoseCache::PoseCache(float frameStep)
+		: m_frameStep{frameStep}
+		, m_hits{0}
+	{}
+
+	uint64_t PoseCache::RigKey(const Skeleton& skeleton, const std::vector<IkChain>& ikChains)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (size_t i = 0; i < skeleton.Size(); ++i)
+		{
+			HashBytes(hash, skeleton.Name(i).data(), skeleton.Name(i).size());
+			HashValue(hash, skeleton.Parent(i));
+			for (size_t c = 0; c < 3; ++c)
+				HashValue(hash, skeleton.BindPosition(i)(c));
+		}
+		for (const IkChain& chain : ikChains)
+		{
+			HashValue(hash, chain.ikBone);
+			HashValue(hash, chain.target);
+			HashValue(hash, chain.loopCount);
+			HashValue(hash, chain.limitAngle);
+			for (const IkLink& link : chain.links)
+			{
+				HashValue(hash, link.bone);
+				HashValue(hash, link.hasLimits);
+				for (size_t c = 0; c < 3; ++c)
+				{
+					HashValue(hash, link.minAngle(c));
+					HashValue(hash, link.maxAngle(c));
+				}
+			}
+		}
+		return hash;
+	}
+
+	float PoseCache::Quantize(float frame) const
+	{
+		return m_frameStep > 0.0f ? std::round(frame / m_frameStep) * m_frameStep : frame;
+	}
+
+	uint32_t PoseCache::Acquire(const Key& key, uint32_t paletteOffset)
+	{
+		const auto [it, inserted] = m_palettes.try_emplace(key, paletteOffset);
+		if (!inserted)
+			++m_hits;
+		return it->second;
+	}
+
+	void PoseCache::Clear()
+	{
+		m_palettes.clear();
+		m_hits = 0;
+	}
+}
@@ -0,0 +1,125 @@
+#include "vk/stagingring.hpp"
+
+namespace democollection::vk
+{
+	StagingRing::StagingRing(const Vulkan& vulkan, VkDeviceSize capacity)
+		: m_vulkan{vulkan}
+		, m_data{}
+		, m_capacity{}
+		, m_head{0}
+		, m_pendingBegin{0}
+		, m_closedRegions{0}
+		, m_retiredRegions{0}
+	{
+		Grow(capacity);
+	}
+
+	StagingRing::~StagingRing()
+	{
+		WaitIdle();
+		for (VkFence& fence : m_freeFences)
+			SAFE_DESTROY(vkDestroyFence, fence, m_vulkan.Device(), fence, m_vulkan.Allocator());
+	}
+
+	bool StagingRing::RetireOldest(bool wait)
+	{
+		Region& region = m_regions.front();
+		if (wait)
+			ThrowIfFailed(vkWaitForFences(m_vulkan.Device(), 1, &region.fence, VK_TRUE, UINT64_MAX));
+		else if (vkGetFenceStatus(m_vulkan.Device(), region.fence) != VK_SUCCESS)
+			return false;
+		ThrowIfFailed(vkResetFences(m_vulkan.Device(), 1, &region.fence));
+		m_freeFences.push_back(region.fence);
+		m_regions.pop_front();
+		++m_retiredRegions;
+		return true;
+	}
+
+	void StagingRing::Grow(VkDeviceSize size)
+	{
+		ThrowIfFalse(!HasPending(), "The staging ring cannot grow while it holds unsubmitted data");
+		WaitIdle();
+		m_buffer.reset();
+		m_capacity = std::max(m_capacity * 2, size);
+		m_buffer = std::make_unique<vk::Buffer>(m_vulkan, vk::Buffer::Type::Staging, m_capacity);
+		m_data = static_cast<uint8_t*>(m_buffer->Mapped());
+		m_head = m_pendingBegin = 0;
+	}
+
+	bool StagingRing::Push(const void* data, VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize alignment)
+	{
+		if (size > m_capacity)
+		{
+			if (HasPending())
+				return false;
+			Grow(size);
+		}
+		Retire();
+		while (true)
+		{
+			// nothing in use, start over at the front
+			if (m_regions.empty() && !HasPending())
+				m_head = m_pendingBegin = 0;
+
+			// the used part runs from the tail to the head and may wrap around the end;
+			// the head never catches up with the tail, equal means empty
+			const VkDeviceSize tail = Tail();
+			const bool empty = m_regions.empty() && !HasPending();
+			offset = (m_head + alignment - 1) / alignment * alignment;
+			if (m_head >= tail || empty)
+			{
+				if (offset + size <= m_capacity)
+					break;
+				// wrap, the rest of the end stays unused until the tail passes it
+				if (size < tail || empty)
+				{
+					offset = 0;
+					break;
+				}
+			}
+			else if (offset + size < tail)
+			{
+				break;
+			}
+
+			if (m_regions.empty())
+				return false;
+			RetireOldest(true);
+		}
+
+		memcpy(m_data + offset, data, size);
+		m_head = offset + size;
+		return true;
+	}
+
+	VkFence StagingRing::CloseRegion()
+	{
+		VkFence fence = VK_NULL_HANDLE;
+		if (m_freeFences.empty())
+		{
+			VkFenceCreateInfo fenceInfo{};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			ThrowIfFailed(vkCreateFence(m_vulkan.Device(), &fenceInfo, m_vulkan.Allocator(), &fence));
+		}
+		else
+		{
+			fence = m_freeFences.back();
+			m_freeFences.pop_back();
+		}
+		m_regions.push_back(Region{m_pendingBegin, fence});
+		m_pendingBegin = m_head;
+		++m_closedRegions;
+		return fence;
+	}
+
+	void StagingRing::Retire()
+	{
+		while (!m_regions.empty() && RetireOldest(false));
+	}
+
+	void StagingRing::WaitIdle()
+	{
+		while (!m_regions.empty())
+			RetireOldest(true);
+	}
+}
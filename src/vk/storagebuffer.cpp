@@ -0,0 +1,12 @@
+#include "vk/storagebuffer.hpp"
+
+namespace democollection::vk
+{
+	StorageBuffer::StorageBuffer(const Vulkan& vulkan, VkDeviceSize size)
+		: PerFrameBuffer(vulkan, Type::Storage, size)
+		, m_mappedData{}
+	{
+		// host visible memory stays mapped for the lifetime of its block
+		m_mappedData = m_memory.mapped;
+	}
+}
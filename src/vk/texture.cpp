@@ -1,6 +1,6 @@
 #include "vk/texture.hpp"
-#include "vk/buffer.hpp"
-#include "vk/singletimecommandbuffer.hpp"
+#include "vk/deletionqueue.hpp"
+#include "vk/transferbatch.hpp"
 #include <cmath>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -12,16 +12,19 @@ namespace democollection::vk
 		: m_vulkan{vulkan}
 		, m_image{VK_NULL_HANDLE}
 		, m_view{VK_NULL_HANDLE}
-		, m_memory{VK_NULL_HANDLE}
+		, m_memory{}
 		, m_sampler{VK_NULL_HANDLE}
 	{}
 
 	TextureResources::~TextureResources()
 	{
-		SAFE_DESTROY(vkDestroySampler, m_sampler, m_vulkan.Device(), m_sampler, m_vulkan.Allocator());
-		SAFE_DESTROY(vkDestroyImage, m_image, m_vulkan.Device(), m_image, m_vulkan.Allocator());
-		SAFE_DESTROY(vkDestroyImageView, m_view, m_vulkan.Device(), m_view, m_vulkan.Allocator());
-		SAFE_DESTROY(vkFreeMemory, m_memory, m_vulkan.Device(), m_memory, m_vulkan.Allocator());
+		// frames in flight may still sample the image
+		m_vulkan.Deletions().Push([&vulkan = m_vulkan, sampler = m_sampler, image = m_image, view = m_view, memory = m_memory]() mutable {
+			SAFE_DESTROY(vkDestroySampler, sampler, vulkan.Device(), sampler, vulkan.Allocator());
+			SAFE_DESTROY(vkDestroyImageView, view, vulkan.Device(), view, vulkan.Allocator());
+			SAFE_DESTROY(vkDestroyImage, image, vulkan.Device(), image, vulkan.Allocator());
+			vulkan.Memory().Free(memory);
+		});
 	}
 
 	void Texture::Init(const void* pixels, uint32_t width, uint32_t height)
@@ -29,11 +32,16 @@ namespace democollection::vk
 		const VkDeviceSize imageSize = 4ULL * width * height;
 		const uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(static_cast<float>(std::max(width, height)))));
 
-		const Buffer stagingBuffer(m_vulkan, Buffer::Type::Staging, imageSize, pixels);
+		// the upload is recorded into the transfer batch and submitted with the next flush,
+		// the copy may run on the transfer queue but blits need the graphics queue
+		TransferBatch& transfers = m_vulkan.Transfers();
+		const VkDeviceSize offset = transfers.Stage(pixels, imageSize);
 		CreateImage(width, height, mipLevels);
-		TransitionImageLayout(mipLevels);
-		CopyBufferToImage(stagingBuffer.Get(), width, height);
-		GenerateMipmaps(width, height, mipLevels);
+		const VkCommandBuffer transferCommandBuffer = transfers.TransferCommandBuffer();
+		TransitionImageLayout(transferCommandBuffer, mipLevels);
+		CopyBufferToImage(transferCommandBuffer, transfers.StagingBuffer(), offset, width, height);
+		transfers.HandOver(m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+		GenerateMipmaps(transfers.GraphicsCommandBuffer(), width, height, mipLevels);
 		CreateImageView(mipLevels);
 		CreateSampler(mipLevels);
 	}
@@ -57,21 +65,11 @@ namespace democollection::vk
 		imageInfo.flags = 0;
 		ThrowIfFailed(vkCreateImage(m_vulkan.Device(), &imageInfo, m_vulkan.Allocator(), &m_image));
 
-		VkMemoryRequirements memRequirements;
-		vkGetImageMemoryRequirements(m_vulkan.Device(), m_image, &memRequirements);
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = m_vulkan.FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-		ThrowIfFailed(vkAllocateMemory(m_vulkan.Device(), &allocInfo, nullptr, &m_memory));
-
-		vkBindImageMemory(m_vulkan.Device(), m_image, m_memory, 0);
+		m_memory = m_vulkan.AllocateMemory(m_image, MemoryCategory::Texture);
 	}
 
-	void Texture::TransitionImageLayout(uint32_t mipLevels)
+	void Texture::TransitionImageLayout(VkCommandBuffer commandBuffer, uint32_t mipLevels)
 	{
-		SingleTimeCommandBuffer cmdBuffer(m_vulkan);
-
 		VkImageMemoryBarrier barrier{};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -86,17 +84,13 @@ namespace democollection::vk
 		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		barrier.srcAccessMask = 0;
 		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		vkCmdPipelineBarrier(cmdBuffer.CommandBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-		cmdBuffer.Submit();
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 	}
 
-	void Texture::CopyBufferToImage(VkBuffer buffer, uint32_t width, uint32_t height)
+	void Texture::CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t width, uint32_t height)
 	{
-		SingleTimeCommandBuffer cmdBuffer(m_vulkan);
-
 		VkBufferImageCopy region{};
-		region.bufferOffset = 0;
+		region.bufferOffset = offset;
 		region.bufferRowLength = 0;
 		region.bufferImageHeight = 0;
 		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -105,17 +99,14 @@ namespace democollection::vk
 		region.imageSubresource.layerCount = 1;
 		region.imageOffset = { 0, 0, 0};
 		region.imageExtent = {width, height, 1 };
-		vkCmdCopyBufferToImage(cmdBuffer.CommandBuffer(), buffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-		cmdBuffer.Submit();
+		vkCmdCopyBufferToImage(commandBuffer, buffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 	}
 
-	void Texture::GenerateMipmaps(uint32_t width, uint32_t height, uint32_t mipLevels)
+	void Texture::GenerateMipmaps(VkCommandBuffer commandBuffer, uint32_t width, uint32_t height, uint32_t mipLevels)
 	{
 		VkFormatProperties formatProperties;
 		vkGetPhysicalDeviceFormatProperties(m_vulkan.Gpu().Device(), VK_FORMAT_R8G8B8A8_SRGB, &formatProperties);
 		ThrowIfFalse(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
-		SingleTimeCommandBuffer cmdBuffer(m_vulkan);
 
 		VkImageMemoryBarrier barrier{};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -147,7 +138,7 @@ namespace democollection::vk
 			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
-			vkCmdPipelineBarrier(cmdBuffer.CommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
 					0, nullptr, 0, nullptr, 1, &barrier);
 
 			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
@@ -157,7 +148,7 @@ namespace democollection::vk
 			blit.dstOffsets[1] = { mipWidth, mipHeight, 1 };
 			blit.dstSubresource.mipLevel = i;
 
-			vkCmdBlitImage(cmdBuffer.CommandBuffer(),
+			vkCmdBlitImage(commandBuffer,
 					m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 					m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 					1, &blit, VK_FILTER_LINEAR);
@@ -167,7 +158,7 @@ namespace democollection::vk
 			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-			vkCmdPipelineBarrier(cmdBuffer.CommandBuffer(),
+			vkCmdPipelineBarrier(commandBuffer,
 					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
 					0, nullptr, 0, nullptr, 1, &barrier);
 		}
@@ -178,11 +169,9 @@ namespace democollection::vk
 		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-		vkCmdPipelineBarrier(cmdBuffer.CommandBuffer(),
+		vkCmdPipelineBarrier(commandBuffer,
 				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
 				0, nullptr, 0, nullptr, 1, &barrier);
-
-		cmdBuffer.Submit();
 	}
 
 	void Texture::CreateImageView(uint32_t mipLevels)
@@ -0,0 +1,175 @@
+#include "vk/tlsf.hpp"
+
+#include <bit>
+
+namespace democollection::vk
+{
+	void Tlsf::Mapping(VkDeviceSize size, uint32_t& fl, uint32_t& sl)
+	{
+		fl = static_cast<uint32_t>(std::bit_width(size)) - 1;
+		sl = fl < SL_BITS ? 0 : static_cast<uint32_t>(size >> (fl - SL_BITS)) & (SL_COUNT - 1);
+	}
+
+	uint32_t Tlsf::NewRange(VkDeviceSize offset, VkDeviceSize size)
+	{
+		uint32_t index;
+		if (m_unusedRanges.empty())
+		{
+			index = static_cast<uint32_t>(m_ranges.size());
+			m_ranges.emplace_back();
+		}
+		else
+		{
+			index = m_unusedRanges.back();
+			m_unusedRanges.pop_back();
+		}
+		m_ranges[index] = Range{offset, size, NO_RANGE, NO_RANGE, NO_RANGE, NO_RANGE, m_ranges[index].generation, false};
+		return index;
+	}
+
+	void Tlsf::InsertFree(uint32_t range)
+	{
+		Range& r = m_ranges[range];
+		uint32_t fl, sl;
+		Mapping(r.size, fl, sl);
+		r.free = true;
+		r.prevFree = NO_RANGE;
+		r.nextFree = m_freeLists[fl][sl];
+		if (r.nextFree != NO_RANGE)
+			m_ranges[r.nextFree].prevFree = range;
+		m_freeLists[fl][sl] = range;
+		m_flBitmap |= 1ull << fl;
+		m_slBitmaps[fl] |= 1u << sl;
+	}
+
+	void Tlsf::RemoveFree(uint32_t range)
+	{
+		Range& r = m_ranges[range];
+		uint32_t fl, sl;
+		Mapping(r.size, fl, sl);
+		if (r.prevFree != NO_RANGE)
+			m_ranges[r.prevFree].nextFree = r.nextFree;
+		else
+			m_freeLists[fl][sl] = r.nextFree;
+		if (r.nextFree != NO_RANGE)
+			m_ranges[r.nextFree].prevFree = r.prevFree;
+		if (m_freeLists[fl][sl] == NO_RANGE)
+		{
+			m_slBitmaps[fl] &= ~(1u << sl);
+			if (!m_slBitmaps[fl])
+				m_flBitmap &= ~(1ull << fl);
+		}
+		r.free = false;
+	}
+
+	void Tlsf::Merge(uint32_t first, uint32_t second)
+	{
+		Range& a = m_ranges[first];
+		const Range& b = m_ranges[second];
+		a.size += b.size;
+		a.nextPhysical = b.nextPhysical;
+		if (a.nextPhysical != NO_RANGE)
+			m_ranges[a.nextPhysical].prevPhysical = first;
+		m_unusedRanges.push_back(second);
+	}
+
+	Tlsf::Tlsf(VkDeviceSize size)
+		: m_flBitmap{0}
+		, m_slBitmaps{}
+		, m_size{size}
+		, m_used{0}
+		, m_allocationCount{0}
+	{
+		for (uint32_t (&lists)[SL_COUNT] : m_freeLists)
+			for (uint32_t& list : lists)
+				list = NO_RANGE;
+		if (size)
+			InsertFree(NewRange(0, size));
+	}
+
+	Tlsf::Handle Tlsf::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+	{
+		size = std::max<VkDeviceSize>(size, 1);
+		alignment = std::max<VkDeviceSize>(alignment, 1);
+		// look in the first class whose ranges are all large enough, including the worst case alignment padding
+		VkDeviceSize request = std::max<VkDeviceSize>(size + alignment - 1, SL_COUNT);
+		uint32_t fl, sl;
+		Mapping(request, fl, sl);
+		if (fl >= SL_BITS)
+		{
+			request += (VkDeviceSize{1} << (fl - SL_BITS)) - 1;
+			Mapping(request, fl, sl);
+		}
+		if (fl >= FL_COUNT)
+			return NONE;
+
+		uint32_t slMap = m_slBitmaps[fl] & (~0u << sl);
+		if (!slMap)
+		{
+			const uint64_t flMap = fl + 1 < FL_COUNT ? m_flBitmap & (~0ull << (fl + 1)) : 0;
+			if (!flMap)
+				return NONE;
+			fl = static_cast<uint32_t>(std::countr_zero(flMap));
+			slMap = m_slBitmaps[fl];
+		}
+		sl = static_cast<uint32_t>(std::countr_zero(slMap));
+		const uint32_t range = m_freeLists[fl][sl];
+		RemoveFree(range);
+
+		// give the alignment padding in front and the rest behind back to the free lists
+		offset = (m_ranges[range].offset + alignment - 1) / alignment * alignment;
+		const VkDeviceSize padding = offset - m_ranges[range].offset;
+		if (padding)
+		{
+			const uint32_t front = NewRange(m_ranges[range].offset, padding);
+			m_ranges[front].prevPhysical = m_ranges[range].prevPhysical;
+			m_ranges[front].nextPhysical = range;
+			if (m_ranges[front].prevPhysical != NO_RANGE)
+				m_ranges[m_ranges[front].prevPhysical].nextPhysical = front;
+			m_ranges[range].prevPhysical = front;
+			m_ranges[range].offset = offset;
+			m_ranges[range].size -= padding;
+			InsertFree(front);
+		}
+		if (m_ranges[range].size > size)
+		{
+			const uint32_t back = NewRange(offset + size, m_ranges[range].size - size);
+			m_ranges[back].prevPhysical = range;
+			m_ranges[back].nextPhysical = m_ranges[range].nextPhysical;
+			if (m_ranges[back].nextPhysical != NO_RANGE)
+				m_ranges[m_ranges[back].nextPhysical].prevPhysical = back;
+			m_ranges[range].nextPhysical = back;
+			m_ranges[range].size = size;
+			InsertFree(back);
+		}
+
+		m_used += size;
+		++m_allocationCount;
+		return Handle{m_ranges[range].generation} << 32 | range;
+	}
+
+	void Tlsf::Free(Handle handle)
+	{
+		uint32_t range = static_cast<uint32_t>(handle);
+		ThrowIfFalse(range < m_ranges.size() && !m_ranges[range].free && m_ranges[range].generation == handle >> 32,
+				"Freeing a range that is not allocated");
+		++m_ranges[range].generation;
+		m_used -= m_ranges[range].size;
+		--m_allocationCount;
+
+		const uint32_t next = m_ranges[range].nextPhysical;
+		if (next != NO_RANGE && m_ranges[next].free)
+		{
+			RemoveFree(next);
+			Merge(range, next);
+		}
+		const uint32_t prev = m_ranges[range].prevPhysical;
+		if (prev != NO_RANGE && m_ranges[prev].free)
+		{
+			RemoveFree(prev);
+			Merge(prev, range);
+			range = prev;
+		}
+		InsertFree(range);
+	}
+}
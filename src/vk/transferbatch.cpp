@@ -0,0 +1,237 @@
+#include "vk/transferbatch.hpp"
+
+namespace democollection::vk
+{
+	TransferBatch::TransferBatch(const Vulkan& vulkan, StagingRing& staging)
+		: m_vulkan{vulkan}
+		, m_staging{staging}
+		, m_dedicated{vulkan.Gpu().HasDedicatedTransferQueue()}
+		, m_transferCommandBuffer{VK_NULL_HANDLE}
+		, m_graphicsCommandBuffer{VK_NULL_HANDLE}
+		, m_stagedBytes{0}
+	{}
+
+	TransferBatch::~TransferBatch()
+	{
+		// whatever is still recording is dropped, it was going to be freed anyway
+		if (m_transferCommandBuffer)
+			m_freeTransferCommandBuffers.push_back(m_transferCommandBuffer);
+		if (m_graphicsCommandBuffer)
+			m_freeGraphicsCommandBuffers.push_back(m_graphicsCommandBuffer);
+		m_staging.WaitIdle();
+		for (const Submission& submission : m_submissions)
+		{
+			if (submission.transferCommandBuffer)
+				m_freeTransferCommandBuffers.push_back(submission.transferCommandBuffer);
+			m_freeGraphicsCommandBuffers.push_back(submission.graphicsCommandBuffer);
+			if (submission.semaphore)
+				m_freeSemaphores.push_back(submission.semaphore);
+		}
+		if (!m_freeTransferCommandBuffers.empty())
+			vkFreeCommandBuffers(m_vulkan.Device(), m_vulkan.TransferCommandPool(), static_cast<uint32_t>(m_freeTransferCommandBuffers.size()), m_freeTransferCommandBuffers.data());
+		if (!m_freeGraphicsCommandBuffers.empty())
+			vkFreeCommandBuffers(m_vulkan.Device(), m_vulkan.CommandPool(), static_cast<uint32_t>(m_freeGraphicsCommandBuffers.size()), m_freeGraphicsCommandBuffers.data());
+		for (VkSemaphore& semaphore : m_freeSemaphores)
+			SAFE_DESTROY(vkDestroySemaphore, semaphore, m_vulkan.Device(), semaphore, m_vulkan.Allocator());
+	}
+
+	void TransferBatch::Retire()
+	{
+		// the fence is on the graphics submission, which waits for the transfer one
+		m_staging.Retire();
+		while (!m_submissions.empty() && m_submissions.front().region <= m_staging.RetiredRegions())
+		{
+			const Submission& submission = m_submissions.front();
+			if (submission.transferCommandBuffer)
+				m_freeTransferCommandBuffers.push_back(submission.transferCommandBuffer);
+			m_freeGraphicsCommandBuffers.push_back(submission.graphicsCommandBuffer);
+			if (submission.semaphore)
+				m_freeSemaphores.push_back(submission.semaphore);
+			m_submissions.pop_front();
+		}
+	}
+
+	VkCommandBuffer TransferBatch::Begin(VkCommandPool pool, std::vector<VkCommandBuffer>& freeCommandBuffers)
+	{
+		if (!IsRecording())
+			m_recordStart = std::chrono::steady_clock::now();
+
+		Retire();
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		if (freeCommandBuffers.empty())
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandPool = pool;
+			allocInfo.commandBufferCount = 1;
+			ThrowIfFailed(vkAllocateCommandBuffers(m_vulkan.Device(), &allocInfo, &commandBuffer));
+		}
+		else
+		{
+			commandBuffer = freeCommandBuffers.back();
+			freeCommandBuffers.pop_back();
+			ThrowIfFailed(vkResetCommandBuffer(commandBuffer, 0));
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		ThrowIfFailed(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+		return commandBuffer;
+	}
+
+	VkDeviceSize TransferBatch::Stage(const void* data, VkDeviceSize size)
+	{
+		if (IsRecording() && (m_stagedBytes >= FLUSH_BYTES || std::chrono::steady_clock::now() - m_recordStart >= FLUSH_AGE))
+			Submit();
+
+		VkDeviceSize offset;
+		if (!m_staging.Push(data, size, offset))
+		{
+			// the ring is full of this batch, send it off so the ring can recycle it
+			Submit();
+			ThrowIfFalse(m_staging.Push(data, size, offset));
+		}
+		m_stagedBytes += size;
+		return offset;
+	}
+
+	VkCommandBuffer TransferBatch::TransferCommandBuffer()
+	{
+		if (!m_dedicated)
+			return GraphicsCommandBuffer();
+		if (!m_transferCommandBuffer)
+			m_transferCommandBuffer = Begin(m_vulkan.TransferCommandPool(), m_freeTransferCommandBuffers);
+		return m_transferCommandBuffer;
+	}
+
+	VkCommandBuffer TransferBatch::GraphicsCommandBuffer()
+	{
+		if (!m_graphicsCommandBuffer)
+			m_graphicsCommandBuffer = Begin(m_vulkan.CommandPool(), m_freeGraphicsCommandBuffers);
+		return m_graphicsCommandBuffer;
+	}
+
+	void TransferBatch::HandOver(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size)
+	{
+		if (!m_dedicated)
+			return;
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = m_vulkan.Gpu().TransferQueueIndex();
+		barrier.dstQueueFamilyIndex = m_vulkan.Gpu().GraphicsQueueIndex();
+		barrier.buffer = buffer;
+		barrier.offset = offset;
+		barrier.size = size;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		vkCmdPipelineBarrier(TransferCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+				0, nullptr, 1, &barrier, 0, nullptr);
+
+		// the graphics submission waits for the copies at the transfer stage, the acquire chains from there
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(GraphicsCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+				0, nullptr, 1, &barrier, 0, nullptr);
+	}
+
+	void TransferBatch::HandOver(VkImage image, VkImageLayout layout, uint32_t mipLevels)
+	{
+		if (!m_dedicated)
+			return;
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = layout;
+		barrier.newLayout = layout;
+		barrier.srcQueueFamilyIndex = m_vulkan.Gpu().TransferQueueIndex();
+		barrier.dstQueueFamilyIndex = m_vulkan.Gpu().GraphicsQueueIndex();
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		vkCmdPipelineBarrier(TransferCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+				0, nullptr, 0, nullptr, 1, &barrier);
+
+		// images are finished on the graphics queue, mip blits and transitions for sampling
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(GraphicsCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+				0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	void TransferBatch::CopyToBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
+	{
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = Stage(data, size);
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(TransferCommandBuffer(), StagingBuffer(), dst, 1, &copyRegion);
+		HandOver(dst, dstOffset, size);
+	}
+
+	void TransferBatch::Submit()
+	{
+		if (!IsRecording())
+			return;
+
+		VkSemaphore semaphore = VK_NULL_HANDLE;
+		if (m_transferCommandBuffer)
+		{
+			ThrowIfFailed(vkEndCommandBuffer(m_transferCommandBuffer));
+			if (m_freeSemaphores.empty())
+			{
+				VkSemaphoreCreateInfo semaphoreInfo{};
+				semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+				ThrowIfFailed(vkCreateSemaphore(m_vulkan.Device(), &semaphoreInfo, m_vulkan.Allocator(), &semaphore));
+			}
+			else
+			{
+				semaphore = m_freeSemaphores.back();
+				m_freeSemaphores.pop_back();
+			}
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &m_transferCommandBuffer;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &semaphore;
+			ThrowIfFailed(vkQueueSubmit(m_vulkan.TransferQueue(), 1, &submitInfo, VK_NULL_HANDLE));
+		}
+
+		// later submissions on the graphics queue read the uploads as vertices, indices and in shaders
+		const VkCommandBuffer graphicsCommandBuffer = GraphicsCommandBuffer();
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(graphicsCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+				1, &barrier, 0, nullptr, 0, nullptr);
+		ThrowIfFailed(vkEndCommandBuffer(graphicsCommandBuffer));
+
+		const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		const VkFence fence = m_staging.CloseRegion();
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = semaphore ? 1 : 0;
+		submitInfo.pWaitSemaphores = &semaphore;
+		submitInfo.pWaitDstStageMask = &waitStage;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &graphicsCommandBuffer;
+		ThrowIfFailed(vkQueueSubmit(m_vulkan.Queue(), 1, &submitInfo, fence));
+
+		m_submissions.push_back(Submission{m_transferCommandBuffer, graphicsCommandBuffer, semaphore, m_staging.ClosedRegions()});
+		m_transferCommandBuffer = VK_NULL_HANDLE;
+		m_graphicsCommandBuffer = VK_NULL_HANDLE;
+		m_stagedBytes = 0;
+	}
+}
@@ -6,6 +6,7 @@ namespace democollection::vk
 		: PerFrameBuffer(vulkan, Type::Uniform, size)
 		, m_mappedData{}
 	{
-		ThrowIfFailed(vkMapMemory(m_vulkan.Device(), m_memory, 0, m_size * MAX_FRAMES_IN_FLIGHT, 0, &m_mappedData));
+		// host visible memory stays mapped for the lifetime of its block
+		m_mappedData = m_memory.mapped;
 	}
 }
@@ -1,4 +1,6 @@
 #include "vk/mesh.hpp"
+#include "vk/transferbatch.hpp"
+#include "vk/deletionqueue.hpp"
 #include <iostream>
 
 namespace democollection::vk
@@ -94,21 +96,26 @@ namespace democollection::vk
 #endif
 		, m_surface{VK_NULL_HANDLE}
 		, m_device{VK_NULL_HANDLE}
+		, m_memoryAllocator{}
 		, m_swapchain{VK_NULL_HANDLE}
 		, m_swapchainImages{}
 		, m_swapchainImageViews{}
 		, m_swapchainFrameBuffers{}
 		, m_colorImage{VK_NULL_HANDLE}
-		, m_colorImageMemory{VK_NULL_HANDLE}
+		, m_colorImageMemory{}
 		, m_colorImageView{VK_NULL_HANDLE}
 		, m_depthImage{VK_NULL_HANDLE}
-		, m_depthImageMemory{VK_NULL_HANDLE}
+		, m_depthImageMemory{}
 		, m_depthImageView{VK_NULL_HANDLE}
 		, m_renderPass{VK_NULL_HANDLE}
 		, m_descriptorSetLayout{VK_NULL_HANDLE}
 		, m_pipelineLayout{VK_NULL_HANDLE}
 		, m_graphicsPipeline{VK_NULL_HANDLE}
+		, m_skinningDescriptorSetLayout{VK_NULL_HANDLE}
+		, m_skinningPipelineLayout{VK_NULL_HANDLE}
+		, m_skinningPipelines{}
 		, m_commandPool{VK_NULL_HANDLE}
+		, m_transferCommandPool{VK_NULL_HANDLE}
 		, m_commandBuffers{}
 		, m_imageAvailableSemaphore{}
 		, m_renderFinishedSemaphore{}
@@ -121,6 +128,8 @@ namespace democollection::vk
 			m_renderFinishedSemaphore[i] = VK_NULL_HANDLE;
 			m_inFlightFences[i] = VK_NULL_HANDLE;
 		}
+		for (VkPipeline& pipeline : m_skinningPipelines)
+			pipeline = VK_NULL_HANDLE;
 	}
 
 	VulkanResources::~VulkanResources()
@@ -139,11 +148,17 @@ namespace democollection::vk
 				cb = VK_NULL_HANDLE;
 		}
 		SAFE_DESTROY(vkDestroyCommandPool, m_commandPool, m_device, m_commandPool, Allocator());
+		SAFE_DESTROY(vkDestroyCommandPool, m_transferCommandPool, m_device, m_transferCommandPool, Allocator());
+		for (VkPipeline& pipeline : m_skinningPipelines)
+			SAFE_DESTROY(vkDestroyPipeline, pipeline, m_device, pipeline, Allocator());
+		SAFE_DESTROY(vkDestroyPipelineLayout, m_skinningPipelineLayout, m_device, m_skinningPipelineLayout, Allocator());
+		SAFE_DESTROY(vkDestroyDescriptorSetLayout, m_skinningDescriptorSetLayout, m_device, m_skinningDescriptorSetLayout, Allocator());
 		SAFE_DESTROY(vkDestroyPipeline, m_graphicsPipeline, m_device, m_graphicsPipeline, Allocator());
 		SAFE_DESTROY(vkDestroyPipelineLayout, m_pipelineLayout, m_device, m_pipelineLayout, Allocator());
 		SAFE_DESTROY(vkDestroyDescriptorSetLayout, m_descriptorSetLayout, m_device, m_descriptorSetLayout, Allocator());
 		SAFE_DESTROY(vkDestroyRenderPass, m_renderPass, m_device, m_renderPass, Allocator());
 
+		m_memoryAllocator.reset();
 		SAFE_DESTROY(vkDestroyDevice, m_device, m_device, Allocator());
 		SAFE_DESTROY(vkDestroySurfaceKHR, m_surface, m_instance, m_surface, Allocator());
 #if VALIDATION_LAYER_ENABLED
@@ -155,10 +170,12 @@ namespace democollection::vk
 	void VulkanResources::CleanupScreenResources()
 	{
 		SAFE_DESTROY(vkDestroyImage, m_colorImage, m_device, m_colorImage, Allocator());
-		SAFE_DESTROY(vkFreeMemory, m_colorImageMemory, m_device, m_colorImageMemory, Allocator());
+		if (m_memoryAllocator)
+			m_memoryAllocator->Free(m_colorImageMemory);
 		SAFE_DESTROY(vkDestroyImageView, m_colorImageView, m_device, m_colorImageView, Allocator());
 		SAFE_DESTROY(vkDestroyImage, m_depthImage, m_device, m_depthImage, Allocator());
-		SAFE_DESTROY(vkFreeMemory, m_depthImageMemory, m_device, m_depthImageMemory, Allocator());
+		if (m_memoryAllocator)
+			m_memoryAllocator->Free(m_depthImageMemory);
 		SAFE_DESTROY(vkDestroyImageView, m_depthImageView, m_device, m_depthImageView, Allocator());
 		for (VkFramebuffer& frameBuffer: m_swapchainFrameBuffers)
 			SAFE_DESTROY(vkDestroyFramebuffer, frameBuffer, m_device, frameBuffer, Allocator());
@@ -198,7 +215,7 @@ namespace democollection::vk
 		appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 		appInfo.pEngineName = name;
 		appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-		appInfo.apiVersion = VK_API_VERSION_1_0;
+		appInfo.apiVersion = VK_API_VERSION_1_1;
 
 		VkInstanceCreateInfo instanceInfo{};
 		instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -261,21 +278,29 @@ namespace democollection::vk
 
 	void Vulkan::CreateLogicalDevice()
 	{
-		VkDeviceQueueCreateInfo queueCreateInfos[2]{};
-
-		const uint32_t queueCount = m_physicalDevice.GraphicsQueueIndex() == m_physicalDevice.PresentQueueIndex() ? 1 : 2;
+		VkDeviceQueueCreateInfo queueCreateInfos[3]{};
 
+		uint32_t queueCount = 1;
 		float queuePriority = 1.0f;
 		queueCreateInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 		queueCreateInfos[0].queueFamilyIndex = m_physicalDevice.GraphicsQueueIndex();
 		queueCreateInfos[0].queueCount = 1;
 		queueCreateInfos[0].pQueuePriorities = &queuePriority;
-		if (queueCount > 1)
+		if (m_physicalDevice.GraphicsQueueIndex() != m_physicalDevice.PresentQueueIndex())
+		{
+			queueCreateInfos[queueCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+			queueCreateInfos[queueCount].queueFamilyIndex = m_physicalDevice.PresentQueueIndex();
+			queueCreateInfos[queueCount].queueCount = 1;
+			queueCreateInfos[queueCount].pQueuePriorities = &queuePriority;
+			++queueCount;
+		}
+		if (m_physicalDevice.HasDedicatedTransferQueue() && m_physicalDevice.TransferQueueIndex() != m_physicalDevice.PresentQueueIndex())
 		{
-			queueCreateInfos[1].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-			queueCreateInfos[1].queueFamilyIndex = m_physicalDevice.PresentQueueIndex();
-			queueCreateInfos[1].queueCount = 1;
-			queueCreateInfos[1].pQueuePriorities = &queuePriority;
+			queueCreateInfos[queueCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+			queueCreateInfos[queueCount].queueFamilyIndex = m_physicalDevice.TransferQueueIndex();
+			queueCreateInfos[queueCount].queueCount = 1;
+			queueCreateInfos[queueCount].pQueuePriorities = &queuePriority;
+			++queueCount;
 		}
 
 		VkPhysicalDeviceFeatures deviceFeatures{};
@@ -287,8 +312,11 @@ namespace democollection::vk
 		deviceInfo.queueCreateInfoCount = queueCount;
 		deviceInfo.pQueueCreateInfos = queueCreateInfos;
 		deviceInfo.pEnabledFeatures = &deviceFeatures;
-		deviceInfo.enabledExtensionCount = ARRAY_SIZE(PhysicalDevice::sDeviceExtensions);
-		deviceInfo.ppEnabledExtensionNames = PhysicalDevice::sDeviceExtensions;
+		std::vector<const char*> extensions(std::begin(PhysicalDevice::sDeviceExtensions), std::end(PhysicalDevice::sDeviceExtensions));
+		if (m_physicalDevice.HasMemoryBudget())
+			extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		deviceInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+		deviceInfo.ppEnabledExtensionNames = extensions.data();
 #if VALIDATION_LAYER_ENABLED
 		deviceInfo.enabledLayerCount = ARRAY_SIZE(g_ValidationLayers);
 		deviceInfo.ppEnabledLayerNames = g_ValidationLayers;
@@ -296,6 +324,7 @@ namespace democollection::vk
 		ThrowIfFailed(vkCreateDevice(m_physicalDevice.Device(), &deviceInfo, Allocator(), &m_device));
 		vkGetDeviceQueue(m_device, m_physicalDevice.GraphicsQueueIndex(), 0, &m_graphicsQueue);
 		vkGetDeviceQueue(m_device, m_physicalDevice.PresentQueueIndex(), 0, &m_presentQueue);
+		vkGetDeviceQueue(m_device, m_physicalDevice.TransferQueueIndex(), 0, &m_transferQueue);
 	}
 
 	uint32_t Vulkan::ChooseImageCount() const
@@ -408,7 +437,7 @@ namespace democollection::vk
 			imageInfo.flags = 0;
 			ThrowIfFailed(vkCreateImage(m_device, &imageInfo, Allocator(), &m_colorImage));
 
-			m_colorImageMemory = AllocateMemory(m_colorImage);
+			m_colorImageMemory = AllocateMemory(m_colorImage, MemoryCategory::Attachment);
 
 			VkImageViewCreateInfo viewInfo{};
 			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -447,7 +476,7 @@ namespace democollection::vk
 		imageInfo.flags = 0;
 		ThrowIfFailed(vkCreateImage(m_device, &imageInfo, Allocator(), &m_depthImage));
 
-		m_depthImageMemory = AllocateMemory(m_depthImage);
+		m_depthImageMemory = AllocateMemory(m_depthImage, MemoryCategory::Attachment);
 
 		VkImageViewCreateInfo viewInfo{};
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -544,7 +573,7 @@ namespace democollection::vk
 
 	void Vulkan::CreateDescriptorSetLayout()
 	{
-		VkDescriptorSetLayoutBinding bindings[5]{};
+		VkDescriptorSetLayoutBinding bindings[4]{};
 
 		VkDescriptorSetLayoutBinding& sceneBufferVertexShaderLayoutBinding = bindings[0];
 		sceneBufferVertexShaderLayoutBinding.binding = 0;
@@ -552,25 +581,20 @@ namespace democollection::vk
 		sceneBufferVertexShaderLayoutBinding.descriptorCount = 1;
 		sceneBufferVertexShaderLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-		VkDescriptorSetLayoutBinding& modelBufferVertexShaderLayoutBinding = bindings[1];
-		modelBufferVertexShaderLayoutBinding.binding = 1;
-		modelBufferVertexShaderLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		modelBufferVertexShaderLayoutBinding.descriptorCount = 1;
-		modelBufferVertexShaderLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-
-		VkDescriptorSetLayoutBinding& sceneBufferFragmentShaderLayoutBinding = bindings[2];
+		VkDescriptorSetLayoutBinding& sceneBufferFragmentShaderLayoutBinding = bindings[1];
 		sceneBufferFragmentShaderLayoutBinding.binding = 2;
 		sceneBufferFragmentShaderLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 		sceneBufferFragmentShaderLayoutBinding.descriptorCount = 1;
 		sceneBufferFragmentShaderLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-		VkDescriptorSetLayoutBinding& modelBufferFragmentShaderLayoutBinding = bindings[3];
+		VkDescriptorSetLayoutBinding& modelBufferFragmentShaderLayoutBinding = bindings[2];
 		modelBufferFragmentShaderLayoutBinding.binding = 3;
-		modelBufferFragmentShaderLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		// materials of all models, the push constant selects the draw's
+		modelBufferFragmentShaderLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 		modelBufferFragmentShaderLayoutBinding.descriptorCount = 1;
 		modelBufferFragmentShaderLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-		VkDescriptorSetLayoutBinding& samplerLayoutBinding = bindings[4];
+		VkDescriptorSetLayoutBinding& samplerLayoutBinding = bindings[3];
 		samplerLayoutBinding.binding = 4;
 		samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		samplerLayoutBinding.descriptorCount = 1;
@@ -581,6 +605,30 @@ namespace democollection::vk
 		layoutInfo.bindingCount = ARRAY_SIZE(bindings);
 		layoutInfo.pBindings = bindings;
 		ThrowIfFailed(vkCreateDescriptorSetLayout(m_device, &layoutInfo, Allocator(), &m_descriptorSetLayout));
+
+		VkDescriptorSetLayoutBinding skinningBindings[3]{};
+
+		VkDescriptorSetLayoutBinding& paletteLayoutBinding = skinningBindings[0];
+		paletteLayoutBinding.binding = 0;
+		paletteLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		paletteLayoutBinding.descriptorCount = 1;
+		paletteLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding& sourceVerticesLayoutBinding = skinningBindings[1];
+		sourceVerticesLayoutBinding.binding = 1;
+		sourceVerticesLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		sourceVerticesLayoutBinding.descriptorCount = 1;
+		sourceVerticesLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding& skinnedVerticesLayoutBinding = skinningBindings[2];
+		skinnedVerticesLayoutBinding.binding = 2;
+		skinnedVerticesLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		skinnedVerticesLayoutBinding.descriptorCount = 1;
+		skinnedVerticesLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		layoutInfo.bindingCount = ARRAY_SIZE(skinningBindings);
+		layoutInfo.pBindings = skinningBindings;
+		ThrowIfFailed(vkCreateDescriptorSetLayout(m_device, &layoutInfo, Allocator(), &m_skinningDescriptorSetLayout));
 	}
 
 	Vulkan::ShaderModule Vulkan::CreateShaderModule(const std::vector<char>& code) const
@@ -613,37 +661,30 @@ namespace democollection::vk
 		shaderStages[1].pName = "main";
 
 
-		VkVertexInputBindingDescription bindingDescription{};
-		bindingDescription.binding = 0;
-		bindingDescription.stride = sizeof(Vertex);
-		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		// the skinning shader writes everything the vertex shader reads, so one stream serves every model
+		VkVertexInputBindingDescription bindingDescriptions[1]{};
+		bindingDescriptions[0].binding = 0;
+		bindingDescriptions[0].stride = sizeof(SkinnedVertex);
+		bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
-		VkVertexInputAttributeDescription attributeDescriptions[5]{};
+		VkVertexInputAttributeDescription attributeDescriptions[3]{};
 		attributeDescriptions[0].binding = 0;
 		attributeDescriptions[0].location = 0;
 		attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-		attributeDescriptions[0].offset = offsetof(Vertex, position);
+		attributeDescriptions[0].offset = offsetof(SkinnedVertex, position);
 		attributeDescriptions[1].binding = 0;
 		attributeDescriptions[1].location = 1;
 		attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
-		attributeDescriptions[1].offset = offsetof(Vertex, texcoord);
+		attributeDescriptions[1].offset = offsetof(SkinnedVertex, texcoord);
 		attributeDescriptions[2].binding = 0;
 		attributeDescriptions[2].location = 2;
 		attributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
-		attributeDescriptions[2].offset = offsetof(Vertex, normal);
-		attributeDescriptions[3].binding = 0;
-		attributeDescriptions[3].location = 3;
-		attributeDescriptions[3].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-		attributeDescriptions[3].offset = offsetof(Vertex, boneWeights);
-		attributeDescriptions[4].binding = 0;
-		attributeDescriptions[4].location = 4;
-		attributeDescriptions[4].format = VK_FORMAT_R32G32B32A32_UINT;
-		attributeDescriptions[4].offset = offsetof(Vertex, boneIndices);
+		attributeDescriptions[2].offset = offsetof(SkinnedVertex, normal);
 
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-		vertexInputInfo.vertexBindingDescriptionCount = 1;
-		vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+		vertexInputInfo.vertexBindingDescriptionCount = ARRAY_SIZE(bindingDescriptions);
+		vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions;
 		vertexInputInfo.vertexAttributeDescriptionCount = ARRAY_SIZE(attributeDescriptions);
 		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
 
@@ -718,12 +759,17 @@ namespace democollection::vk
 		colorBlendingInfo.blendConstants[2] = 0.0f;
 		colorBlendingInfo.blendConstants[3] = 0.0f;
 
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(MaterialPushConstants);
+
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		pipelineLayoutInfo.setLayoutCount = 1;
 		pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
-		pipelineLayoutInfo.pushConstantRangeCount = 0;
-		pipelineLayoutInfo.pPushConstantRanges = nullptr;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 		ThrowIfFailed(vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, Allocator(), &m_pipelineLayout));
 
 		VkPipelineDepthStencilStateCreateInfo depthStencilInfo{};
@@ -758,6 +804,51 @@ namespace democollection::vk
 		ThrowIfFailed(vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, Allocator(), &m_graphicsPipeline));
 	}
 
+	void Vulkan::CreateSkinningPipeline()
+	{
+		const std::vector<char> compShaderCode = ReadFile((GetProgramFolder() + "skinning_comp.spv").c_str());
+		ShaderModule compShaderModule = CreateShaderModule(compShaderCode);
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(SkinningPushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &m_skinningDescriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		ThrowIfFailed(vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, Allocator(), &m_skinningPipelineLayout));
+
+		// the skinning mode is specialization constant 0 of the shader
+		uint32_t mode = 0;
+		VkSpecializationMapEntry specializationEntry{};
+		specializationEntry.constantID = 0;
+		specializationEntry.offset = 0;
+		specializationEntry.size = sizeof(mode);
+
+		VkSpecializationInfo specializationInfo{};
+		specializationInfo.mapEntryCount = 1;
+		specializationInfo.pMapEntries = &specializationEntry;
+		specializationInfo.dataSize = sizeof(mode);
+		specializationInfo.pData = &mode;
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = compShaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.stage.pSpecializationInfo = &specializationInfo;
+		pipelineInfo.layout = m_skinningPipelineLayout;
+		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+		pipelineInfo.basePipelineIndex = -1;
+		for (mode = 0; mode < ARRAY_SIZE(m_skinningPipelines); ++mode)
+			ThrowIfFailed(vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, Allocator(), &m_skinningPipelines[mode]));
+	}
+
 	void Vulkan::CreateFrameBuffers()
 	{
 		const bool multiSampling = m_physicalDevice.MsaaSampleCount() != VK_SAMPLE_COUNT_1_BIT;
@@ -793,6 +884,12 @@ namespace democollection::vk
 		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 		poolInfo.queueFamilyIndex = m_physicalDevice.GraphicsQueueIndex();
 		ThrowIfFailed(vkCreateCommandPool(m_device, &poolInfo, Allocator(), &m_commandPool));
+
+		if (m_physicalDevice.HasDedicatedTransferQueue())
+		{
+			poolInfo.queueFamilyIndex = m_physicalDevice.TransferQueueIndex();
+			ThrowIfFailed(vkCreateCommandPool(m_device, &poolInfo, Allocator(), &m_transferCommandPool));
+		}
 	}
 
 	void Vulkan::CreateCommandBuffers()
@@ -822,57 +919,32 @@ namespace democollection::vk
 		}
 	}
 
-	void Vulkan::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) const
+	void Vulkan::RecordCommandBuffer(VkCommandBuffer commandBuffer) const
 	{
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		beginInfo.flags = 0;
 		beginInfo.pInheritanceInfo = nullptr;
 		ThrowIfFailed(vkBeginCommandBuffer(commandBuffer, &beginInfo));
-
-		VkViewport viewport{};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(m_swapchainExtent.width);
-		viewport.height = static_cast<float>(m_swapchainExtent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-		VkRect2D scissor{};
-		scissor.offset = { 0, 0 };
-		scissor.extent = m_swapchainExtent;
-		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-		VkClearValue clearValues[2]{};
-		clearValues[0].color = {{ 1.0f, 0.5f, 0.0f, 1.0f }};
-		clearValues[1].depthStencil = { 1.0f, 0 };
-		VkRenderPassBeginInfo renderPassInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = m_renderPass;
-		renderPassInfo.framebuffer = m_swapchainFrameBuffers[imageIndex];
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = m_swapchainExtent;
-		renderPassInfo.clearValueCount = ARRAY_SIZE(clearValues);
-		renderPassInfo.pClearValues = clearValues;
-		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
 	}
 
 	Vulkan::Vulkan(const char* name, GLFWwindow* window)
 		: m_window{window}
 		, m_graphicsQueue{VK_NULL_HANDLE}
 		, m_presentQueue{VK_NULL_HANDLE}
+		, m_transferQueue{VK_NULL_HANDLE}
 		, m_physicalDevice{}
 		, m_currentFrame{0}
 		, m_imageIndex{}
 		, m_resizeRequested{false}
+		, m_stagingRing{}
+		, m_transferBatch{}
 	{
 		CreateInstance(name);
 		ThrowIfFailed(glfwCreateWindowSurface(m_instance, window, Allocator(), &m_surface));
 		m_physicalDevice = SelectPhysicalDevice();
 		CreateLogicalDevice();
+		m_memoryAllocator = std::make_unique<MemoryAllocator>(m_device, m_physicalDevice.Device(), Allocator(), m_physicalDevice.HasMemoryBudget());
 		CreateSwapchain();
 		CreateSwapchainImageResources();
 		CreateColorImageResources();
@@ -880,10 +952,34 @@ namespace democollection::vk
 		CreateRenderPass();
 		CreateDescriptorSetLayout();
 		CreateGraphicsPipeline();
+		CreateSkinningPipeline();
 		CreateFrameBuffers();
 		CreateCommandPool();
 		CreateCommandBuffers();
 		CreateSyncObjects();
+		m_deletionQueue = std::make_unique<DeletionQueue>();
+		m_stagingRing = std::make_unique<StagingRing>(*this);
+		m_transferBatch = std::make_unique<TransferBatch>(*this, *m_stagingRing);
+	}
+
+	Vulkan::~Vulkan()
+	{
+		// both wait for their fences, the device still has to be there
+		m_transferBatch.reset();
+		m_stagingRing.reset();
+		// deferred resources go last, the ring's buffer is one of them
+		Flush();
+		m_deletionQueue.reset();
+	}
+
+	void Vulkan::Flush() const
+	{
+		// a batch still recording may reference resources in the queue, it has to
+		// reach the device before they go; gone already when called from the destructor
+		if (m_transferBatch)
+			m_transferBatch->Submit();
+		vkDeviceWaitIdle(m_device);
+		m_deletionQueue->ReleaseAll();
 	}
 
 	void Vulkan::RecreateSwapchain()
@@ -904,8 +1000,10 @@ namespace democollection::vk
 		}
 	}
 
-	bool Vulkan::BeginRender()
+	bool Vulkan::BeginFrame()
 	{
+		// uploads recorded since the last frame go ahead of it on the queue
+		m_transferBatch->Submit();
 		vkWaitForFences(m_device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
 		const VkResult result = vkAcquireNextImageKHR(m_device, m_swapchain, UINT64_MAX, m_imageAvailableSemaphore[m_currentFrame], VK_NULL_HANDLE, &m_imageIndex);
 		if (VK_ERROR_OUT_OF_DATE_KHR == result)
@@ -918,14 +1016,56 @@ namespace democollection::vk
 			if (VK_SUBOPTIMAL_KHR != result)
 				ThrowIfFailed(result);
 		}
+		m_deletionQueue->NextFrame();
 
 		vkResetFences(m_device, 1, &m_inFlightFences[m_currentFrame]);
 		vkResetCommandBuffer(m_commandBuffers[m_currentFrame], 0);
-		RecordCommandBuffer(m_commandBuffers[m_currentFrame], m_imageIndex);
+		RecordCommandBuffer(m_commandBuffers[m_currentFrame]);
 
 		return true;
 	}
 
+	void Vulkan::BeginRender()
+	{
+		const VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
+
+		// one barrier covers the skinning dispatches of every model
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = static_cast<float>(m_swapchainExtent.width);
+		viewport.height = static_cast<float>(m_swapchainExtent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+		VkRect2D scissor{};
+		scissor.offset = { 0, 0 };
+		scissor.extent = m_swapchainExtent;
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		VkClearValue clearValues[2]{};
+		clearValues[0].color = {{ 1.0f, 0.5f, 0.0f, 1.0f }};
+		clearValues[1].depthStencil = { 1.0f, 0 };
+		VkRenderPassBeginInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = m_renderPass;
+		renderPassInfo.framebuffer = m_swapchainFrameBuffers[m_imageIndex];
+		renderPassInfo.renderArea.offset = { 0, 0 };
+		renderPassInfo.renderArea.extent = m_swapchainExtent;
+		renderPassInfo.clearValueCount = ARRAY_SIZE(clearValues);
+		renderPassInfo.pClearValues = clearValues;
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+	}
+
 	void Vulkan::EndRender()
 	{
 		vkCmdEndRenderPass(m_commandBuffers[m_currentFrame]);
@@ -968,30 +1108,11 @@ namespace democollection::vk
 
 	uint32_t Vulkan::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
 	{
-		VkPhysicalDeviceMemoryProperties memProperties{};
-		vkGetPhysicalDeviceMemoryProperties(m_physicalDevice.Device(), &memProperties);
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
-			if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-				return i;
-		Throw("failed to find suitable memory type");
+		return m_memoryAllocator->FindMemoryType(typeFilter, properties);
 	}
 
-	VkDeviceMemory Vulkan::AllocateMemory(VkImage image) const
+	Allocation Vulkan::AllocateMemory(VkImage image, MemoryCategory category) const
 	{
-		VkDeviceMemory memory = VK_NULL_HANDLE;
-
-		VkMemoryRequirements memRequirements;
-		vkGetImageMemoryRequirements(m_device, image, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-		ThrowIfFailed(vkAllocateMemory(m_device, &allocInfo, Allocator(), &memory));
-
-		ThrowIfFailed(vkBindImageMemory(m_device, image, memory, 0));
-
-		return memory;
+		return m_memoryAllocator->AllocateImage(image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, category);
 	}
 }
@@ -0,0 +1,94 @@
+#include "vmdloader.hpp"
+
+namespace democollection
+{
+#define READ(primitive) infile.read((char*)&(primitive), sizeof(primitive))
+#define READ_SOME(address, length) infile.read((char*)(address), length)
+
+#define RETURN_IF_ERROR(status) do{VmdLoader::Status st=status;if(st!=VmdLoader::Status::Ok)return st;}while(false)
+
+	VmdLoader::Status VmdLoader::Load()
+	{
+		RETURN_IF_ERROR(LoadHeader());
+		RETURN_IF_ERROR(LoadBoneKeyframes());
+		return Ok;
+	}
+
+	VmdLoader::Status VmdLoader::LoadHeader()
+	{
+		std::ifstream& infile = m_infile;
+		char signature[30] = {};
+		READ(signature);
+
+		// files written before version 2 have a shorter model name
+		size_t modelNameLength;
+		if (0 == memcmp(signature, "Vocaloid Motion Data 0002", 25))
+			modelNameLength = 20;
+		else if (0 == memcmp(signature, "Vocaloid Motion Data file", 25))
+			modelNameLength = 10;
+		else
+			return SignatureError;
+
+		char modelName[20] = {};
+		READ_SOME(modelName, modelNameLength);
+		if (!infile)
+			return SignatureError;
+		m_modelName = ShiftJisToUtf8(modelName, strnlen(modelName, modelNameLength));
+		return Ok;
+	}
+
+	VmdLoader::Status VmdLoader::LoadBoneKeyframes()
+	{
+		std::ifstream& infile = m_infile;
+		uint32_t keyframeCount = 0;
+		READ(keyframeCount);
+		if (!infile)
+			return BoneError;
+
+		// keyframes of different bones are interleaved; names are converted once per bone
+		std::map<std::string, size_t> trackIndices;
+		for (uint32_t i = 0; i < keyframeCount; ++i)
+		{
+			char boneName[15] = {};
+			BoneKeyframe keyframe;
+			uint8_t interpolation[64];
+			READ(boneName);
+			READ(keyframe.frame);
+			READ(keyframe.translation);
+			READ(keyframe.rotation);
+			READ(interpolation);
+			if (!infile)
+				return BoneError;
+
+			const std::string rawName(boneName, strnlen(boneName, sizeof(boneName)));
+			auto [track, inserted] = trackIndices.emplace(rawName, m_motion.boneTracks.size());
+			if (inserted)
+				m_motion.boneTracks.push_back(BoneTrack{ShiftJisToUtf8(rawName.data(), rawName.size()), {}});
+
+			// four interleaved curves: x1 of every curve, then y1, x2 and y2
+			for (int c = 0; c < 4; ++c)
+			{
+				keyframe.curves[c].x1 = interpolation[c] / 127.0f;
+				keyframe.curves[c].y1 = interpolation[c + 4] / 127.0f;
+				keyframe.curves[c].x2 = interpolation[c + 8] / 127.0f;
+				keyframe.curves[c].y2 = interpolation[c + 12] / 127.0f;
+			}
+			m_motion.lastFrame = std::max(m_motion.lastFrame, keyframe.frame);
+			m_motion.boneTracks[track->second].keyframes.push_back(keyframe);
+		}
+
+		for (BoneTrack& track : m_motion.boneTracks)
+		{
+			std::stable_sort(track.keyframes.begin(), track.keyframes.end(), [](const BoneKeyframe& lhs, const BoneKeyframe& rhs)->bool{
+				return lhs.frame < rhs.frame;
+			});
+		}
+		return Ok;
+	}
+
+	VmdLoader::VmdLoader(Motion& motion, const char filename[])
+		: m_motion{motion}
+		, m_infile(filename, std::ios::binary)
+		, m_status{m_infile.is_open() ? Load() : FileNotFound}
+	{}
+}